@@ -1,43 +1,276 @@
+/* Count distinct lines of stdin and the largest count of any line.
+ *
+ *   gcc -O2 -I../ext dict_v1.c -o dict_v1 -lpthread
+ *   ./dict_v1 [-a] [-t nThreads] < input
+ *
+ * -a estimates both numbers in bounded memory; -t N counts with N threads.
+ * Neither mode needs libm. */
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
 #include "khash.h"
+#include "ksketch.h"
 KHASH_MAP_INIT_STR(str, int)
+KSS_INIT_STR(str)
 
 #define BUF_SIZE 0x10000
-#define BLOCK_SIZE 0x100000
+#define CHUNK_SIZE 0x800000
+
+/* Estimate the two numbers in bounded memory. The distinct lines are counted
+ * by HyperLogLog. The max count is an upper bound: a line tracked by
+ * Space-Saving is bounded by its slot and its Count-Min estimate, and any
+ * other line by both the Space-Saving floor and the largest Count-Min
+ * estimate seen */
+static void count_approx(char *buf)
+{
+	int i;
+	khint64_t c, max = 0, max_cm = 0;
+	kcm_t *cm = kcm_init(4, 20);
+	khll_t *hll = khll_init(14);
+	kss_t(str) *ss = kss_init(str, 1024);
+	while (!feof(stdin)) {
+		khint64_t x;
+		fgets(buf, BUF_SIZE, stdin);
+		x = kh_strn_hash_func64(buf, strlen(buf));
+		khll_add(hll, x);
+		c = kcm_add(cm, x, 1);
+		if (c > max_cm) max_cm = c;
+		kss_add(str, ss, buf, 1);
+	}
+	for (i = 0; i < (int)kss_n(ss); ++i) {
+		const char *s = kss_key(ss, i);
+		c = kcm_get(cm, kh_strn_hash_func64(s, strlen(s)));
+		if (kss_cnt(ss, i) < c) c = kss_cnt(ss, i);
+		if (c > max) max = c;
+	}
+	c = kss_floor(ss) < max_cm? kss_floor(ss) : max_cm;
+	if (c > max) max = c;
+	printf("%.0f\t%lu\n", khll_count(hll), (unsigned long)max);
+	kss_destroy(str, ss);
+	khll_destroy(hll);
+	kcm_destroy(cm);
+}
+
+/* Parallel mode. The main thread reads stdin in chunks cut at newlines,
+ * overlapped with the workers processing the previous chunk. A worker first
+ * splits its slice of the chunk into the keys the serial loop would see,
+ * i.e. lines broken every BUF_SIZE-1 bytes as fgets() does, and routes them
+ * by hash; after a barrier, each worker inserts the keys routed to it into
+ * its own table, so the partitions are disjoint and no table is shared. */
+typedef struct {
+	size_t n, m, *a;
+} offv_t;
+
+typedef struct {
+	char *s;
+	size_t len, cut, m; // s[0..cut) is processed; s[cut..len) is carried to the next chunk
+} chunk_t;
+
+typedef struct {
+	int n_threads, eof;
+	const char *chunk;
+	size_t len;
+	pthread_barrier_t start, mid, done;
+	struct worker_s *w;
+} shared_t;
+
+typedef struct worker_s {
+	int t, max;
+	shared_t *s;
+	char *kbuf; // NUL-terminated keys of the slice
+	size_t kl, km;
+	offv_t *route; // offsets in kbuf of keys for each partition
+	khash_t(str) *h;
+} worker_t;
+
+static inline int partition(const char *key, int n)
+{
+	return (int)(((khint64_t)(kh_str_hash_func(key) * 0x9e3779b1U) * n) >> 32);
+}
+
+static size_t slice_start(const char *s, size_t len, int t, int n)
+{
+	size_t p = len * t / n;
+	if (t == 0 || t == n) return t == 0? 0 : len;
+	if (p == 0) p = 1;
+	while (p < len && s[p-1] != '\n') ++p;
+	return p;
+}
+
+static void add_key(worker_t *w, const char *key)
+{
+	int ret;
+	khint_t k = kh_put_str_intern(str, w->h, key, &ret);
+	if (ret) kh_val(w->h, k) = 1;
+	else if (++kh_val(w->h, k) > w->max) w->max = kh_val(w->h, k);
+}
+
+static void split_slice(worker_t *w)
+{
+	shared_t *s = w->s;
+	size_t i, end = slice_start(s->chunk, s->len, w->t + 1, s->n_threads);
+	for (i = 0; i < (size_t)s->n_threads; ++i) w->route[i].n = 0;
+	w->kl = 0;
+	for (i = slice_start(s->chunk, s->len, w->t, s->n_threads); i < end;) {
+		const char *q = (const char*)memchr(s->chunk + i, '\n', end - i);
+		size_t l = (q? (size_t)(q - s->chunk) + 1 : end) - i;
+		offv_t *r;
+		if (l > BUF_SIZE - 1) l = BUF_SIZE - 1; // fgets() stops here
+		if (w->kl + l + 1 > w->km) {
+			w->km = (w->kl + l + 1) << 1;
+			w->kbuf = (char*)realloc(w->kbuf, w->km);
+		}
+		memcpy(w->kbuf + w->kl, s->chunk + i, l);
+		w->kbuf[w->kl + l] = 0;
+		r = &w->route[partition(w->kbuf + w->kl, s->n_threads)];
+		if (r->n == r->m) {
+			r->m = r->m? r->m << 1 : 256;
+			r->a = (size_t*)realloc(r->a, r->m * sizeof(size_t));
+		}
+		r->a[r->n++] = w->kl;
+		w->kl += l + 1, i += l;
+	}
+}
+
+static void *worker(void *data)
+{
+	worker_t *w = (worker_t*)data;
+	shared_t *s = w->s;
+	int t;
+	size_t j;
+	for (;;) {
+		pthread_barrier_wait(&s->start);
+		if (s->eof) break;
+		split_slice(w);
+		pthread_barrier_wait(&s->mid);
+		for (t = 0; t < s->n_threads; ++t)
+			for (j = 0; j < s->w[t].route[w->t].n; ++j)
+				add_key(w, s->w[t].kbuf + s->w[t].route[w->t].a[j]);
+		pthread_barrier_wait(&s->done);
+	}
+	return 0;
+}
+
+static size_t read_chunk(chunk_t *c, const chunk_t *prev)
+{
+	size_t l = prev? prev->len - prev->cut : 0;
+	if (c->m < l + CHUNK_SIZE) {
+		c->m = l + CHUNK_SIZE;
+		c->s = (char*)realloc(c->s, c->m);
+	}
+	if (l) memcpy(c->s, prev->s + prev->cut, l);
+	c->len = l;
+	for (;;) {
+		char *p;
+		c->len += fread(c->s + c->len, 1, c->m - c->len, stdin);
+		if (c->len < c->m) { // end of input
+			c->cut = c->len;
+			break;
+		}
+		for (p = c->s + c->len; p > c->s && p[-1] != '\n'; --p);
+		if (p > c->s) {
+			c->cut = p - c->s;
+			break;
+		}
+		c->m <<= 1; // a line longer than the buffer
+		c->s = (char*)realloc(c->s, c->m);
+	}
+	return c->cut;
+}
+
+static void count_parallel(int n_threads)
+{
+	shared_t s;
+	worker_t *w;
+	pthread_t *tid;
+	chunk_t c[2];
+	int t, cur = 0, last = -1, max = 1;
+	khint_t size = 0;
+	memset(&s, 0, sizeof(s));
+	memset(c, 0, sizeof(c));
+	s.n_threads = n_threads;
+	s.w = w = (worker_t*)calloc(n_threads, sizeof(worker_t));
+	tid = (pthread_t*)calloc(n_threads, sizeof(pthread_t));
+	pthread_barrier_init(&s.start, 0, n_threads + 1);
+	pthread_barrier_init(&s.mid, 0, n_threads);
+	pthread_barrier_init(&s.done, 0, n_threads + 1);
+	for (t = 0; t < n_threads; ++t) {
+		w[t].t = t, w[t].max = 1, w[t].s = &s;
+		w[t].route = (offv_t*)calloc(n_threads, sizeof(offv_t));
+		w[t].h = kh_init(str);
+		pthread_create(&tid[t], 0, worker, &w[t]);
+	}
+	if (read_chunk(&c[0], 0)) {
+		do {
+			s.chunk = c[cur].s, s.len = c[cur].cut;
+			pthread_barrier_wait(&s.start);
+			last = cur, cur ^= 1;
+			read_chunk(&c[cur], &c[last]); // while the workers process c[last]
+			pthread_barrier_wait(&s.done);
+		} while (c[cur].cut);
+	}
+	s.eof = 1;
+	pthread_barrier_wait(&s.start);
+	for (t = 0; t < n_threads; ++t) pthread_join(tid[t], 0);
+	{ // the serial loop counts the last key again unless fgets() hit EOF while reading it
+		char *key = (char*)calloc(BUF_SIZE, 1); // on empty input, it counts its empty buffer
+		int again = 1;
+		if (last >= 0) {
+			size_t e = c[last].cut, b = e - 1, l;
+			while (b > 0 && c[last].s[b-1] != '\n') --b;
+			l = (e - b - 1) % (BUF_SIZE - 1) + 1; // the last piece of the last line
+			memcpy(key, c[last].s + e - l, l);
+			again = (c[last].s[e-1] == '\n' || l == BUF_SIZE - 1);
+		}
+		if (again) add_key(&w[partition(key, n_threads)], key);
+		free(key);
+	}
+	for (t = 0; t < n_threads; ++t) {
+		size += kh_size(w[t].h);
+		if (w[t].max > max) max = w[t].max;
+		kh_destroy(str, w[t].h);
+		for (cur = 0; cur < n_threads; ++cur) free(w[t].route[cur].a);
+		free(w[t].route); free(w[t].kbuf);
+	}
+	printf("%u\t%d\n", size, max);
+	pthread_barrier_destroy(&s.start);
+	pthread_barrier_destroy(&s.mid);
+	pthread_barrier_destroy(&s.done);
+	free(c[0].s); free(c[1].s); free(w); free(tid);
+}
 
 int main(int argc, char *argv[])
 {
-	char *buf, **mem = 0;
-	int ret, max = 1, block_end = 0, curr = 0;
+	char *buf;
+	int c, ret, max = 1, approx = 0, n_threads = 1;
 	khint_t k;
 	khash_t(str) *h;
+	while ((c = getopt(argc, argv, "at:")) >= 0) {
+		if (c == 'a') approx = 1;
+		else if (c == 't') n_threads = atoi(optarg);
+	}
+	if (!approx && n_threads > 1) {
+		count_parallel(n_threads);
+		return 0;
+	}
 	buf = malloc(BUF_SIZE); // string buffer
-	h = kh_init(str);
-	mem = malloc(sizeof(void*));
-	mem[0] = malloc(BLOCK_SIZE); // memory buffer to avoid memory fragments
-	curr = block_end = 0;
+	if (approx) {
+		count_approx(buf);
+		free(buf);
+		return 0;
+	}
+	h = kh_init(str); // keys are copied to the table's arena
 	while (!feof(stdin)) {
 		fgets(buf, BUF_SIZE, stdin);
-		k = kh_put(str, h, buf, &ret);
-		if (ret) { // absent
-			int l = strlen(buf) + 1;
-			if (block_end + l > BLOCK_SIZE) {
-				++curr; block_end = 0;
-				mem = realloc(mem, (curr + 1) * sizeof(void*));
-				mem[curr] = malloc(BLOCK_SIZE);
-			}
-			memcpy(mem[curr] + block_end, buf, l);
-			kh_key(h, k) = mem[curr] + block_end;
-			block_end += l;
-			kh_val(h, k) = 1;
-		} else {
+		k = kh_put_str_intern(str, h, buf, &ret);
+		if (ret) kh_val(h, k) = 1; // absent
+		else {
 			++kh_val(h, k);
 			if (kh_val(h, k) > max) max = kh_val(h, k);
 		}
 	}
 	printf("%u\t%d\n", kh_size(h), max);
-	for (ret = 0; ret <= curr; ++ret) free(mem[ret]);
-	free(mem);
 	kh_destroy(str, h);
 	free(buf);
 	return 0;
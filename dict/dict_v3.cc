@@ -0,0 +1,19 @@
+#include <utility>
+#include <iostream>
+#include "khash.hpp"
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+	kh::map<string, int> h;
+	string s;
+	int max = 1, ret;
+	while (getline(cin, s).good()) {
+		khint_t k = h.put(s, &ret);
+		if (ret) h.value(k) = 1;
+		else if (max < ++h.value(k)) max = h.value(k);
+	}
+	cout<<h.size()<<'\t'<<max<<'\n';
+	return 0;
+}
@@ -47,6 +47,124 @@ int main() {
 */
 
 /*
+  2026-10-17 (0.2.29):
+
+	* Renamed kh_sso_t to kh_sso_key_t and kh_put_sso() to kh_sso_put(), so
+	  that a table may be named sso
+
+  2026-10-17 (0.2.28):
+
+	* Renamed kh_sv_t to kh_sv_key_t, so that a table may be named sv
+
+  2026-10-17 (0.2.27):
+
+	* Renamed kh_strh_t to kh_strh_key_t, so that a table may be named strh
+
+  2026-10-17 (0.2.26):
+
+	* Fixed a data race in the parallel resize: buckets are claimed with
+	  an atomic AND instead of a plain read followed by a compare-and-swap
+
+  2026-10-17 (0.2.25):
+
+	* Moved the KH_STATS block ahead of the parallel resize one and
+	  documented that kh_get() updates the statistics through a cast
+	  from const
+
+  2026-10-17 (0.2.24):
+
+	* Fixed KHASH_INIT2_RH tables silently losing a key when a displaced
+	  key could not be placed; kh_put() now returns -1 instead of growing
+	  without bound on keys sharing one hash
+
+  2026-10-17 (0.2.23):
+
+	* Added an allocator hook (kh_allocator_t, kh_set_allocator()) for the
+	  flags, keys and values arrays of KHASH_INIT2 tables
+
+  2026-10-17 (0.2.22):
+
+	* Added kh_merge(), which inserts all elements of a table into another
+	  and combines the values of common keys
+
+  2026-10-17 (0.2.21):
+
+	* Added a statistics mode (KH_STATS) counting probes, collisions,
+	  deletions and resizes, and kh_stats() to print them
+
+  2026-10-17 (0.2.20):
+
+	* Added a multi-threaded, out-of-place kh_resize() for large tables,
+	  enabled by defining KH_PARALLEL_RESIZE
+
+  2026-10-17 (0.2.19):
+
+	* Added kh_reserve(), and kh_build() which inserts arrays of keys and
+	  values in bucket order
+
+  2026-10-17 (0.2.18):
+
+	* Added tables storing each key, value and flag together in one bucket
+	  (KHASH_INIT2_AOS)
+
+  2026-10-17 (0.2.17):
+
+	* Added string keys stored inline in the bucket when shorter than 16
+	  bytes (kh_sso_t)
+
+  2026-10-17 (0.2.16):
+
+	* Added a string arena owned by the table and kh_put_str_intern(),
+	  which copies a key into it on insertion
+
+  2026-10-17 (0.2.15):
+
+	* Added length-carrying string keys (kh_sv_t), which need not be null
+	  terminated
+
+  2026-10-17 (0.2.14):
+
+	* Added kh_strn_hash_func(), a word-at-a-time string hash taking an
+	  explicit length, and its seeded variant
+
+  2026-10-17 (0.2.13):
+
+	* Added string keys carrying their hash (kh_strh_t) so that resizing
+	  never rehashes and strcmp() only runs on a hash match
+
+  2026-10-17 (0.2.12):
+
+	* Added Robin Hood tables with a bounded probe length (KHASH_INIT2_RH)
+
+  2026-10-17 (0.2.11):
+
+	* Added linear-probing tables with backward-shift deletion
+	  (KHASH_INIT2_LP)
+
+  2026-10-17 (0.2.10):
+
+	* Added kh_get_batch() and kh_put_batch(), which hash and prefetch a
+	  window of keys before probing
+
+  2026-10-17 (0.2.9):
+
+	* Added tables that resize incrementally (KHASH_INIT2_INCR)
+
+  2026-10-17 (0.2.8):
+
+	* Added tables with 64-bit bucket indices (KHASH_INIT2_64) and 64-bit
+	  hash functions
+
+  2026-10-17 (0.2.7):
+
+	* Added power-of-2 bucket counts with masking and triangular probing
+	  (KHASH_INIT2_POW2)
+
+  2026-10-17 (0.2.6):
+
+	* Added group-probing tables with one-byte control tags
+	  (KHASH_INIT2_SWISS)
+
   2011-02-14 (0.2.5):
 
     * Allow to declare global functions.
@@ -94,7 +212,7 @@ int main() {
   @copyright Heng Li
  */
 
-#define AC_VERSION_KHASH_H "0.2.5"
+#define AC_VERSION_KHASH_H "0.2.29"
 
 #include <stdlib.h>
 #include <string.h>
@@ -120,6 +238,7 @@ typedef unsigned long long khint64_t;
 
 typedef khint32_t khint_t;
 typedef khint_t khiter_t;
+typedef khint64_t khiter64_t;
 
 #define __ac_HASH_PRIME_SIZE 32
 static const khint32_t __ac_prime_list[__ac_HASH_PRIME_SIZE] =
@@ -140,39 +259,380 @@ static const khint32_t __ac_prime_list[__ac_HASH_PRIME_SIZE] =
 #define __ac_set_isempty_false(flag, i) (flag[i>>4]&=~(2ul<<((i&0xfU)<<1)))
 #define __ac_set_isboth_false(flag, i) (flag[i>>4]&=~(3ul<<((i&0xfU)<<1)))
 #define __ac_set_isdel_true(flag, i) (flag[i>>4]|=1ul<<((i&0xfU)<<1))
+#define __ac_set_isempty_true(flag, i) (flag[i>>4]|=2ul<<((i&0xfU)<<1))
 
 static const double __ac_HASH_UPPER = 0.77;
 
-#define KHASH_DECLARE(name, khkey_t, khval_t)		 					\
+/* number of keys hashed and prefetched ahead by kh_get_batch()/kh_put_batch() */
+#define __ac_BATCH_SIZE 32
+
+/* kh_build() sorts keys by blocks of 2^__ac_BUILD_SHIFT buckets */
+#define __ac_BUILD_SHIFT 10
+
+#if defined(__GNUC__)
+#define __ac_prefetch(p) __builtin_prefetch(p)
+#else
+#define __ac_prefetch(p) ((void)(p))
+#endif
+
+/*
+  Statistics. With KH_STATS defined before including this file, tables of
+  KHASH_INIT2/KHASH_INIT2_POW2/KHASH_INIT2_64 carry a kh_stats_t counting,
+  separately for kh_get() and kh_put(), the number of calls, of buckets
+  probed and of calls that probed more than one bucket (collisions), with a
+  histogram of probe lengths; plus deletions, resizes and the CPU time
+  spent resizing. kh_stats() prints them with the current load and number
+  of deleted buckets. Counting is not thread-safe, even for kh_get(). As
+  kh_get() takes a const table, it casts the const away to update the
+  counters; this is safe for tables from kh_init(), but a table must not be
+  defined as a const object. When KH_STATS is not defined the counters and
+  kh_stats() expand to nothing.
+ */
+#ifdef KH_STATS
+#include <stdio.h>
+#include <time.h>
+
+#define __ac_STATS_HIST 16
+
+typedef struct {
+	khint64_t n_call[2], n_probe[2], n_coll[2], hist[2][__ac_STATS_HIST];
+	khint64_t n_del, n_resize;
+	clock_t resize_clock;
+} kh_stats_t;
+
+static inline void __ac_stats_probe(kh_stats_t *s, int is_put, khint64_t n)
+{
+	++s->n_call[is_put];
+	s->n_probe[is_put] += n;
+	if (n > 1) ++s->n_coll[is_put];
+	++s->hist[is_put][n < __ac_STATS_HIST? n - 1 : __ac_STATS_HIST - 1];
+}
+
+static inline void __ac_stats_print(const kh_stats_t *s, FILE *fp, khint64_t n_buckets, khint64_t size, khint64_t n_occupied)
+{
+	static const char *op[2] = { "get", "put" };
+	int i, j;
+	fprintf(fp, "buckets\t%llu\nsize\t%llu\nload\t%.3f\ndeleted\t%llu\n", (unsigned long long)n_buckets,
+			(unsigned long long)size, n_buckets? (double)size / n_buckets : 0., (unsigned long long)(n_occupied - size));
+	for (i = 0; i < 2; ++i) {
+		fprintf(fp, "%s\t%llu calls\t%.3f probes/call\t%llu collisions\n", op[i], (unsigned long long)s->n_call[i],
+				s->n_call[i]? (double)s->n_probe[i] / s->n_call[i] : 0., (unsigned long long)s->n_coll[i]);
+		for (j = 0; j < __ac_STATS_HIST; ++j)
+			if (s->hist[i][j])
+				fprintf(fp, "%s_probes\t%s%d\t%llu\n", op[i], j == __ac_STATS_HIST - 1? ">=" : "", j + 1, (unsigned long long)s->hist[i][j]);
+	}
+	fprintf(fp, "del\t%llu\nresize\t%llu\t%.3f sec\n", (unsigned long long)s->n_del, (unsigned long long)s->n_resize,
+			(double)s->resize_clock / CLOCKS_PER_SEC);
+}
+
+#define __ac_STATS_FIELD kh_stats_t stats;
+#define __ac_stat(x) x
+#define __KHASH_STATS_IMPL(name, SCOPE)									\
+	SCOPE void kh_stats_##name(const kh_##name##_t *h, FILE *fp)		\
+	{																	\
+		__ac_stats_print(&h->stats, fp, h->n_buckets, h->size, h->n_occupied); \
+	}
+/*! @function
+  @abstract     Print statistics of a hash table.
+  @param  name  Name of the hash table [symbol]
+  @param  h     Pointer to the hash table [khash_t(name)*]
+  @param  fp    Output stream [FILE*]
+ */
+#define kh_stats(name, h, fp) kh_stats_##name(h, fp)
+#else
+#define __ac_STATS_FIELD
+#define __ac_stat(x)
+#define __KHASH_STATS_IMPL(name, SCOPE)
+#define kh_stats(name, h, fp) ((void)0)
+#endif
+
+/*
+  Parallel resize. With KH_PARALLEL_RESIZE defined before including this
+  file, kh_resize() of a KHASH_INIT2/KHASH_INIT2_POW2/KHASH_INIT2_64 table
+  with at least __ac_PAR_MIN buckets before or after resizing allocates new
+  arrays, splits the old buckets into KH_RESIZE_THREADS ranges (by default
+  one per online CPU) and moves each range in its own thread. As keys are
+  known to be distinct, a thread only needs to claim a free bucket, which it
+  does by clearing its "empty" bit with an atomic AND on the flags word. Old and new arrays coexist during the resize. Requires GCC builtins
+  and POSIX threads.
+ */
+#ifdef KH_PARALLEL_RESIZE
+#include <pthread.h>
+#include <unistd.h>
+
+#ifndef __ac_PAR_MIN
+#define __ac_PAR_MIN (1U<<22)
+#endif
+#define __ac_PAR_MAX_THREADS 256
+
+static inline int __ac_par_n_threads(void)
+{
+#ifdef KH_RESIZE_THREADS
+	int n = KH_RESIZE_THREADS;
+#else
+	int n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	return n < 1? 1 : n > __ac_PAR_MAX_THREADS? __ac_PAR_MAX_THREADS : n;
+}
+
+/* mark bucket i as used unless another thread got it first */
+static inline int __ac_par_claim(khint32_t *flags, khint64_t i)
+{
+	khint32_t b = 2U << ((i&0xfU)<<1);
+	return (__atomic_fetch_and(&flags[i>>4], ~b, __ATOMIC_RELAXED) & b) != 0;
+}
+
+#define __KHASH_PAR_IMPL(name, SCOPE, khkey_t, khval_t, kh_is_map, __hash_func, __policy, khidx_t) \
 	typedef struct {													\
-		khint_t n_buckets, size, n_occupied, upper_bound;				\
+		const kh_##name##_t *h;											\
+		khint32_t *flags;												\
+		khkey_t *keys;													\
+		khval_t *vals;													\
+		khidx_t n_buckets, beg, end;									\
+	} kh_par_##name##_t;												\
+	static void *kh_par_worker_##name(void *data)						\
+	{																	\
+		kh_par_##name##_t *w = (kh_par_##name##_t*)data;				\
+		const kh_##name##_t *h = w->h;									\
+		khidx_t j;														\
+		for (j = w->beg; j < w->end; ++j) {								\
+			if (__ac_iseither(h->flags, j) == 0) {						\
+				khidx_t k, i, inc;										\
+				k = __ac_##__policy##_hash(__hash_func(h->keys[j]));	\
+				i = __ac_##__policy##_first(k, w->n_buckets);			\
+				inc = __ac_##__policy##_inc(k, w->n_buckets);			\
+				while (!__ac_par_claim(w->flags, i))					\
+					__ac_##__policy##_next(w->n_buckets, i, inc);		\
+				w->keys[i] = h->keys[j];								\
+				if (kh_is_map) w->vals[i] = h->vals[j];					\
+			}															\
+		}																\
+		return 0;														\
+	}																	\
+	SCOPE int kh_resize_par_##name(kh_##name##_t *h, khidx_t new_n_buckets) \
+	{																	\
+		kh_par_##name##_t w[__ac_PAR_MAX_THREADS];						\
+		pthread_t tid[__ac_PAR_MAX_THREADS];							\
+		int t, n_threads;												\
+		if (h->n_buckets < __ac_PAR_MIN && new_n_buckets < __ac_PAR_MIN) return 0; \
+		n_threads = __ac_par_n_threads();								\
+		if (n_threads == 1) return 0;									\
+		w[0].h = h, w[0].n_buckets = new_n_buckets;						\
+		w[0].flags = (khint32_t*)__ac_alloc(h->alloc, ((new_n_buckets>>4) + 1) * sizeof(khint32_t)); \
+		memset(w[0].flags, 0xaa, ((new_n_buckets>>4) + 1) * sizeof(khint32_t)); \
+		w[0].keys = (khkey_t*)__ac_alloc(h->alloc, new_n_buckets * sizeof(khkey_t)); \
+		w[0].vals = kh_is_map? (khval_t*)__ac_alloc(h->alloc, new_n_buckets * sizeof(khval_t)) : 0; \
+		for (t = 0; t < n_threads; ++t) {								\
+			w[t] = w[0];												\
+			w[t].beg = (khidx_t)((double)h->n_buckets * t / n_threads);	\
+			w[t].end = t == n_threads - 1? h->n_buckets : (khidx_t)((double)h->n_buckets * (t + 1) / n_threads); \
+		}																\
+		for (t = 1; t < n_threads; ++t)									\
+			if (pthread_create(&tid[t], 0, kh_par_worker_##name, &w[t]) != 0) \
+				kh_par_worker_##name(&w[t]), w[t].h = 0; /* run it here instead */ \
+		kh_par_worker_##name(&w[0]);									\
+		for (t = 1; t < n_threads; ++t)									\
+			if (w[t].h) pthread_join(tid[t], 0);						\
+		__ac_free(h->alloc, h->flags, ((h->n_buckets>>4) + 1) * sizeof(khint32_t)); \
+		__ac_free(h->alloc, h->keys, h->n_buckets * sizeof(khkey_t));	\
+		__ac_free(h->alloc, h->vals, h->n_buckets * sizeof(khval_t));	\
+		h->flags = w[0].flags, h->keys = w[0].keys, h->vals = w[0].vals; \
+		h->n_buckets = new_n_buckets;									\
+		h->n_occupied = h->size;										\
+		h->upper_bound = (khidx_t)(h->n_buckets * __ac_HASH_UPPER + 0.5); \
+		return 1;														\
+	}
+
+#define __ac_resize_par(name, h, n) kh_resize_par_##name(h, n)
+#else
+#define __KHASH_PAR_IMPL(name, SCOPE, khkey_t, khval_t, kh_is_map, __hash_func, __policy, khidx_t)
+#define __ac_resize_par(name, h, n) 0
+#endif
+
+/*
+  Bucket-count policies. A policy p defines:
+
+    __ac_p_size(n)             bucket count to use when asked for n buckets
+    __ac_p_hash(k)             transformation applied to the user hash
+    __ac_p_first(k, n)         first bucket probed for hash k
+    __ac_p_inc(k, n)           initial probe state
+    __ac_p_next(n, i, inc)     move i to the next bucket
+    __ac_p_done(n, i, last, inc)  true once all buckets have been probed
+
+  The "prime" policy is the original one: a prime number of buckets and
+  double hashing. The "pow2" policy uses a power-of-2 number of buckets, so
+  that no division is needed, and triangular probing (i + 1 + 2 + ...),
+  which visits every bucket exactly once in the first n probes. As masking
+  only keeps the low bits, the user hash is passed through a finalizer.
+  "pow2_64" is the same with 64-bit hashes and bucket indices.
+ */
+
+/* Murmur3 finalizer; spreads the entropy of weak hash functions over all bits */
+static inline khint32_t __ac_fmix32(khint32_t h)
+{
+	h ^= h >> 16; h *= 0x85ebca6bU;
+	h ^= h >> 13; h *= 0xc2b2ae35U;
+	h ^= h >> 16;
+	return h;
+}
+
+static inline khint_t __ac_prime_size(khint_t n)
+{
+	khint_t t = __ac_HASH_PRIME_SIZE - 1;
+	while (__ac_prime_list[t] > n) --t;
+	return __ac_prime_list[t+1];
+}
+#define __ac_prime_hash(k) (k)
+#define __ac_prime_first(k, n) ((k) % (n))
+#define __ac_prime_inc(k, n) (1 + (k) % ((n) - 1))
+#define __ac_prime_next(n, i, inc) ((i) = (i) + (inc) >= (n)? (i) + (inc) - (n) : (i) + (inc))
+#define __ac_prime_done(n, i, last, inc) ((i) == (last))
+
+static inline khint_t __ac_pow2_size(khint_t n)
+{
+	khint_t t = 4;
+	while (t <= n && t < 0x80000000U) t <<= 1;
+	return t;
+}
+#define __ac_pow2_hash(k) __ac_fmix32(k)
+#define __ac_pow2_first(k, n) ((k) & ((n) - 1))
+#define __ac_pow2_inc(k, n) 0
+#define __ac_pow2_next(n, i, inc) ((i) = ((i) + ++(inc)) & ((n) - 1))
+#define __ac_pow2_done(n, i, last, inc) ((void)(last), (inc) >= (n))
+
+/* Murmur3 64-bit finalizer */
+static inline khint64_t __ac_fmix64(khint64_t h)
+{
+	h ^= h >> 33; h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+static inline khint64_t __ac_pow2_64_size(khint64_t n)
+{
+	khint64_t t = 4;
+	while (t <= n && t < 0x8000000000000000ULL) t <<= 1;
+	return t;
+}
+#define __ac_pow2_64_hash(k) __ac_fmix64(k)
+#define __ac_pow2_64_first(k, n) __ac_pow2_first(k, n)
+#define __ac_pow2_64_inc(k, n) __ac_pow2_inc(k, n)
+#define __ac_pow2_64_next(n, i, inc) __ac_pow2_next(n, i, inc)
+#define __ac_pow2_64_done(n, i, last, inc) __ac_pow2_done(n, i, last, inc)
+
+/* Allocator of bucket arrays; sizes are passed back to realloc() and free().
+   realloc may be NULL, in which case alloc, memcpy and free are used. */
+typedef struct {
+	void *ctx;
+	void *(*alloc)(void *ctx, size_t size);
+	void *(*realloc)(void *ctx, void *p, size_t old_size, size_t size);
+	void (*free)(void *ctx, void *p, size_t size);
+} kh_allocator_t;
+
+static inline void *__ac_alloc(const kh_allocator_t *a, size_t size)
+{
+	return a? a->alloc(a->ctx, size) : malloc(size);
+}
+
+static inline void *__ac_realloc(const kh_allocator_t *a, void *p, size_t old_size, size_t size)
+{
+	void *q;
+	if (a == 0) return realloc(p, size);
+	if (a->realloc) return a->realloc(a->ctx, p, old_size, size);
+	if ((q = a->alloc(a->ctx, size)) != 0 && p) {
+		memcpy(q, p, old_size < size? old_size : size);
+		a->free(a->ctx, p, old_size);
+	}
+	return q;
+}
+
+static inline void __ac_free(const kh_allocator_t *a, void *p, size_t size)
+{
+	if (a == 0) free(p);
+	else if (p) a->free(a->ctx, p, size);
+}
+
+/* Chunked arena; blocks are chained from the newest, which is the one allocated from */
+typedef struct kh_arena_s {
+	struct kh_arena_s *next;
+	size_t used, cap;
+} kh_arena_t;
+
+#define __ac_ARENA_BLOCK 0x100000
+
+static inline char *__ac_arena_alloc(kh_arena_t **a, size_t l)
+{
+	kh_arena_t *b = *a, *p;
+	if (b && b->used + l <= b->cap) {
+		b->used += l;
+		return (char*)(b + 1) + b->used - l;
+	}
+	p = (kh_arena_t*)malloc(sizeof(kh_arena_t) + (l > __ac_ARENA_BLOCK? l : __ac_ARENA_BLOCK));
+	p->used = l, p->cap = l > __ac_ARENA_BLOCK? l : __ac_ARENA_BLOCK;
+	if (b && l > __ac_ARENA_BLOCK) p->next = b->next, b->next = p; /* keep filling the current block */
+	else p->next = b, *a = p;
+	return (char*)(p + 1);
+}
+
+static inline void __ac_arena_destroy(kh_arena_t *a)
+{
+	while (a) {
+		kh_arena_t *p = a->next;
+		free(a);
+		a = p;
+	}
+}
+
+#define __KHASH_DECLARE(name, khkey_t, khval_t, khidx_t)			 	\
+	typedef struct {													\
+		khidx_t n_buckets, size, n_occupied, upper_bound;				\
 		khint32_t *flags;												\
 		khkey_t *keys;													\
 		khval_t *vals;													\
+		kh_arena_t *arena;												\
+		const kh_allocator_t *alloc;									\
+		__ac_STATS_FIELD												\
 	} kh_##name##_t;													\
 	extern kh_##name##_t *kh_init_##name();								\
 	extern void kh_destroy_##name(kh_##name##_t *h);					\
 	extern void kh_clear_##name(kh_##name##_t *h);						\
-	extern khint_t kh_get_##name(const kh_##name##_t *h, khkey_t key); 	\
-	extern void kh_resize_##name(kh_##name##_t *h, khint_t new_n_buckets); \
-	extern khint_t kh_put_##name(kh_##name##_t *h, khkey_t key, int *ret); \
-	extern void kh_del_##name(kh_##name##_t *h, khint_t x);
-
-#define KHASH_INIT2(name, SCOPE, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
+	extern khidx_t kh_get_hashed_##name(const kh_##name##_t *h, khkey_t key, khidx_t k); \
+	extern khidx_t kh_get_##name(const kh_##name##_t *h, khkey_t key); 	\
+	extern void kh_get_batch_##name(const kh_##name##_t *h, size_t n, const khkey_t *keys, khidx_t *iters); \
+	extern void kh_resize_##name(kh_##name##_t *h, khidx_t new_n_buckets); \
+	extern void kh_reserve_##name(kh_##name##_t *h, khidx_t n);			\
+	extern khidx_t kh_put_hashed_##name(kh_##name##_t *h, khkey_t key, khidx_t k, int *ret); \
+	extern khidx_t kh_put_##name(kh_##name##_t *h, khkey_t key, int *ret); \
+	extern void kh_put_batch_##name(kh_##name##_t *h, size_t n, const khkey_t *keys, khidx_t *iters, int *rets); \
+	extern void kh_build_##name(kh_##name##_t *h, size_t n, const khkey_t *keys, const khval_t *vals); \
+	extern void kh_merge_##name(kh_##name##_t *dst, const kh_##name##_t *src, khval_t (*combine)(khval_t, khval_t)); \
+	extern void kh_del_##name(kh_##name##_t *h, khidx_t x);
+
+#define KHASH_DECLARE(name, khkey_t, khval_t) __KHASH_DECLARE(name, khkey_t, khval_t, khint_t)
+#define KHASH_DECLARE64(name, khkey_t, khval_t) __KHASH_DECLARE(name, khkey_t, khval_t, khint64_t)
+
+#define __KHASH_IMPL(name, SCOPE, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal, __policy, khidx_t) \
 	typedef struct {													\
-		khint_t n_buckets, size, n_occupied, upper_bound;				\
+		khidx_t n_buckets, size, n_occupied, upper_bound;				\
 		khint32_t *flags;												\
 		khkey_t *keys;													\
 		khval_t *vals;													\
+		kh_arena_t *arena;												\
+		const kh_allocator_t *alloc;									\
+		__ac_STATS_FIELD												\
 	} kh_##name##_t;													\
+	__KHASH_STATS_IMPL(name, SCOPE)										\
 	SCOPE kh_##name##_t *kh_init_##name() {								\
 		return (kh_##name##_t*)calloc(1, sizeof(kh_##name##_t));		\
 	}																	\
 	SCOPE void kh_destroy_##name(kh_##name##_t *h)						\
 	{																	\
 		if (h) {														\
-			free(h->keys); free(h->flags);								\
-			free(h->vals);												\
+			__ac_free(h->alloc, h->keys, h->n_buckets * sizeof(khkey_t)); \
+			__ac_free(h->alloc, h->flags, ((h->n_buckets>>4) + 1) * sizeof(khint32_t)); \
+			__ac_free(h->alloc, h->vals, h->n_buckets * sizeof(khval_t)); \
+			__ac_arena_destroy(h->arena);								\
 			free(h);													\
 		}																\
 	}																	\
@@ -183,36 +643,70 @@ static const double __ac_HASH_UPPER = 0.77;
 			h->size = h->n_occupied = 0;								\
 		}																\
 	}																	\
-	SCOPE khint_t kh_get_##name(const kh_##name##_t *h, khkey_t key) 	\
+	SCOPE khidx_t kh_get_hashed_##name(const kh_##name##_t *h, khkey_t key, khidx_t k) \
 	{																	\
 		if (h->n_buckets) {												\
-			khint_t inc, k, i, last;									\
-			k = __hash_func(key); i = k % h->n_buckets;					\
-			inc = 1 + k % (h->n_buckets - 1); last = i;					\
+			khidx_t inc, i, last;										\
+			__ac_stat(khint64_t n_probe = 1;)							\
+			i = __ac_##__policy##_first(k, h->n_buckets);				\
+			inc = __ac_##__policy##_inc(k, h->n_buckets); last = i;		\
 			while (!__ac_isempty(h->flags, i) && (__ac_isdel(h->flags, i) || !__hash_equal(h->keys[i], key))) { \
-				if (i + inc >= h->n_buckets) i = i + inc - h->n_buckets; \
-				else i += inc;											\
-				if (i == last) return h->n_buckets;						\
+				__ac_##__policy##_next(h->n_buckets, i, inc);			\
+				__ac_stat(++n_probe;)									\
+				if (__ac_##__policy##_done(h->n_buckets, i, last, inc)) { \
+					__ac_stat(__ac_stats_probe(&((kh_##name##_t*)h)->stats, 0, n_probe);) \
+					return h->n_buckets;								\
+				}														\
 			}															\
+			__ac_stat(__ac_stats_probe(&((kh_##name##_t*)h)->stats, 0, n_probe);) \
 			return __ac_iseither(h->flags, i)? h->n_buckets : i;		\
 		} else return 0;												\
 	}																	\
-	SCOPE void kh_resize_##name(kh_##name##_t *h, khint_t new_n_buckets) \
+	SCOPE khidx_t kh_get_##name(const kh_##name##_t *h, khkey_t key) 	\
+	{																	\
+		return kh_get_hashed_##name(h, key, __ac_##__policy##_hash(__hash_func(key))); \
+	}																	\
+	SCOPE void kh_get_batch_##name(const kh_##name##_t *h, size_t n, const khkey_t *keys, khidx_t *iters) \
+	{																	\
+		khidx_t k[__ac_BATCH_SIZE];										\
+		size_t j, l, m;													\
+		if (h->n_buckets == 0) {										\
+			for (j = 0; j < n; ++j) iters[j] = 0;						\
+			return;														\
+		}																\
+		for (j = 0; j < n; j += m) {									\
+			m = n - j < __ac_BATCH_SIZE? n - j : __ac_BATCH_SIZE;		\
+			for (l = 0; l < m; ++l) {									\
+				khidx_t i;												\
+				k[l] = __ac_##__policy##_hash(__hash_func(keys[j+l]));	\
+				i = __ac_##__policy##_first(k[l], h->n_buckets);		\
+				__ac_prefetch(&h->flags[i>>4]);							\
+				__ac_prefetch(&h->keys[i]);								\
+			}															\
+			for (l = 0; l < m; ++l)										\
+				iters[j+l] = kh_get_hashed_##name(h, keys[j+l], k[l]);	\
+		}																\
+	}																	\
+	__KHASH_PAR_IMPL(name, SCOPE, khkey_t, khval_t, kh_is_map, __hash_func, __policy, khidx_t) \
+	SCOPE void kh_resize_##name(kh_##name##_t *h, khidx_t new_n_buckets) \
 	{																	\
 		khint32_t *new_flags = 0;										\
-		khint_t j = 1;													\
+		khidx_t j = 1;													\
+		__ac_stat(clock_t t0 = clock();)								\
 		{																\
-			khint_t t = __ac_HASH_PRIME_SIZE - 1;						\
-			while (__ac_prime_list[t] > new_n_buckets) --t;				\
-			new_n_buckets = __ac_prime_list[t+1];						\
-			if (h->size >= (khint_t)(new_n_buckets * __ac_HASH_UPPER + 0.5)) j = 0;	\
+			new_n_buckets = __ac_##__policy##_size(new_n_buckets);		\
+			if (h->size >= (khidx_t)(new_n_buckets * __ac_HASH_UPPER + 0.5)) j = 0;	\
+			else if (__ac_resize_par(name, h, new_n_buckets)) {			\
+				j = 0;													\
+				__ac_stat(++h->stats.n_resize; h->stats.resize_clock += clock() - t0;) \
+			}															\
 			else {														\
-				new_flags = (khint32_t*)malloc(((new_n_buckets>>4) + 1) * sizeof(khint32_t));	\
+				new_flags = (khint32_t*)__ac_alloc(h->alloc, ((new_n_buckets>>4) + 1) * sizeof(khint32_t)); \
 				memset(new_flags, 0xaa, ((new_n_buckets>>4) + 1) * sizeof(khint32_t)); \
 				if (h->n_buckets < new_n_buckets) {						\
-					h->keys = (khkey_t*)realloc(h->keys, new_n_buckets * sizeof(khkey_t)); \
+					h->keys = (khkey_t*)__ac_realloc(h->alloc, h->keys, h->n_buckets * sizeof(khkey_t), new_n_buckets * sizeof(khkey_t)); \
 					if (kh_is_map)										\
-						h->vals = (khval_t*)realloc(h->vals, new_n_buckets * sizeof(khval_t)); \
+						h->vals = (khval_t*)__ac_realloc(h->alloc, h->vals, h->n_buckets * sizeof(khval_t), new_n_buckets * sizeof(khval_t)); \
 				}														\
 			}															\
 		}																\
@@ -224,14 +718,12 @@ static const double __ac_HASH_UPPER = 0.77;
 					if (kh_is_map) val = h->vals[j];					\
 					__ac_set_isdel_true(h->flags, j);					\
 					while (1) {											\
-						khint_t inc, k, i;								\
-						k = __hash_func(key);							\
-						i = k % new_n_buckets;							\
-						inc = 1 + k % (new_n_buckets - 1);				\
-						while (!__ac_isempty(new_flags, i)) {			\
-							if (i + inc >= new_n_buckets) i = i + inc - new_n_buckets; \
-							else i += inc;								\
-						}												\
+						khidx_t inc, k, i;								\
+						k = __ac_##__policy##_hash(__hash_func(key));	\
+						i = __ac_##__policy##_first(k, new_n_buckets);	\
+						inc = __ac_##__policy##_inc(k, new_n_buckets);	\
+						while (!__ac_isempty(new_flags, i))				\
+							__ac_##__policy##_next(new_n_buckets, i, inc); \
 						__ac_set_isempty_false(new_flags, i);			\
 						if (i < h->n_buckets && __ac_iseither(h->flags, i) == 0) { \
 							{ khkey_t tmp = h->keys[i]; h->keys[i] = key; key = tmp; } \
@@ -246,65 +738,1016 @@ static const double __ac_HASH_UPPER = 0.77;
 				}														\
 			}															\
 			if (h->n_buckets > new_n_buckets) {							\
-				h->keys = (khkey_t*)realloc(h->keys, new_n_buckets * sizeof(khkey_t)); \
+				h->keys = (khkey_t*)__ac_realloc(h->alloc, h->keys, h->n_buckets * sizeof(khkey_t), new_n_buckets * sizeof(khkey_t)); \
 				if (kh_is_map)											\
-					h->vals = (khval_t*)realloc(h->vals, new_n_buckets * sizeof(khval_t)); \
+					h->vals = (khval_t*)__ac_realloc(h->alloc, h->vals, h->n_buckets * sizeof(khval_t), new_n_buckets * sizeof(khval_t)); \
 			}															\
-			free(h->flags);												\
+			__ac_free(h->alloc, h->flags, ((h->n_buckets>>4) + 1) * sizeof(khint32_t)); \
 			h->flags = new_flags;										\
 			h->n_buckets = new_n_buckets;								\
 			h->n_occupied = h->size;									\
-			h->upper_bound = (khint_t)(h->n_buckets * __ac_HASH_UPPER + 0.5); \
+			h->upper_bound = (khidx_t)(h->n_buckets * __ac_HASH_UPPER + 0.5); \
+			__ac_stat(++h->stats.n_resize; h->stats.resize_clock += clock() - t0;) \
 		}																\
 	}																	\
-	SCOPE khint_t kh_put_##name(kh_##name##_t *h, khkey_t key, int *ret) \
+	SCOPE void kh_reserve_##name(kh_##name##_t *h, khidx_t n)			\
+	{																	\
+		if (n > h->size && h->n_occupied + (n - h->size) > h->upper_bound) { \
+			khidx_t t = (khidx_t)(n / __ac_HASH_UPPER) + 1;				\
+			kh_resize_##name(h, t > h->n_buckets? t : h->n_buckets - 1); /* or just clear "deleted" elements */ \
+		}																\
+	}																	\
+	SCOPE khidx_t kh_put_hashed_##name(kh_##name##_t *h, khkey_t key, khidx_t k, int *ret) \
 	{																	\
-		khint_t x;														\
+		khidx_t x;														\
 		if (h->n_occupied >= h->upper_bound) {							\
 			if (h->n_buckets > (h->size<<1)) kh_resize_##name(h, h->n_buckets - 1); \
 			else kh_resize_##name(h, h->n_buckets + 1);					\
 		}																\
 		{																\
-			khint_t inc, k, i, site, last;								\
-			x = site = h->n_buckets; k = __hash_func(key); i = k % h->n_buckets; \
+			khidx_t inc, i, site, last;									\
+			__ac_stat(khint64_t n_probe = 1;)							\
+			x = site = h->n_buckets;									\
+			i = __ac_##__policy##_first(k, h->n_buckets);				\
 			if (__ac_isempty(h->flags, i)) x = i;						\
 			else {														\
-				inc = 1 + k % (h->n_buckets - 1); last = i;				\
+				inc = __ac_##__policy##_inc(k, h->n_buckets); last = i;	\
 				while (!__ac_isempty(h->flags, i) && (__ac_isdel(h->flags, i) || !__hash_equal(h->keys[i], key))) { \
 					if (__ac_isdel(h->flags, i)) site = i;				\
-					if (i + inc >= h->n_buckets) i = i + inc - h->n_buckets; \
-					else i += inc;										\
-					if (i == last) { x = site; break; }					\
+					__ac_##__policy##_next(h->n_buckets, i, inc);		\
+					__ac_stat(++n_probe;)								\
+					if (__ac_##__policy##_done(h->n_buckets, i, last, inc)) { x = site; break; } \
 				}														\
 				if (x == h->n_buckets) {								\
 					if (__ac_isempty(h->flags, i) && site != h->n_buckets) x = site; \
 					else x = i;											\
 				}														\
 			}															\
+			__ac_stat(__ac_stats_probe(&h->stats, 1, n_probe);)			\
+		}																\
+		if (__ac_isempty(h->flags, x)) {								\
+			h->keys[x] = key;											\
+			__ac_set_isboth_false(h->flags, x);							\
+			++h->size; ++h->n_occupied;									\
+			*ret = 1;													\
+		} else if (__ac_isdel(h->flags, x)) {							\
+			h->keys[x] = key;											\
+			__ac_set_isboth_false(h->flags, x);							\
+			++h->size;													\
+			*ret = 2;													\
+		} else *ret = 0;												\
+		return x;														\
+	}																	\
+	SCOPE khidx_t kh_put_##name(kh_##name##_t *h, khkey_t key, int *ret) \
+	{																	\
+		return kh_put_hashed_##name(h, key, __ac_##__policy##_hash(__hash_func(key)), ret); \
+	}																	\
+	SCOPE void kh_put_batch_##name(kh_##name##_t *h, size_t n, const khkey_t *keys, khidx_t *iters, int *rets) \
+	{																	\
+		khidx_t k[__ac_BATCH_SIZE];										\
+		size_t j, l, m;													\
+		kh_reserve_##name(h, h->size + n); /* no resize in the loop, so that iters stay valid */ \
+		for (j = 0; j < n; j += m) {									\
+			m = n - j < __ac_BATCH_SIZE? n - j : __ac_BATCH_SIZE;		\
+			for (l = 0; l < m; ++l) {									\
+				khidx_t i;												\
+				k[l] = __ac_##__policy##_hash(__hash_func(keys[j+l]));	\
+				i = __ac_##__policy##_first(k[l], h->n_buckets);		\
+				__ac_prefetch(&h->flags[i>>4]);							\
+				__ac_prefetch(&h->keys[i]);								\
+				if (kh_is_map) __ac_prefetch(&h->vals[i]);				\
+			}															\
+			for (l = 0; l < m; ++l)										\
+				iters[j+l] = kh_put_hashed_##name(h, keys[j+l], k[l], &rets[j+l]); \
+		}																\
+	}																	\
+	SCOPE void kh_build_##name(kh_##name##_t *h, size_t n, const khkey_t *keys, const khval_t *vals) \
+	{																	\
+		khidx_t *k, *sk, x;												\
+		khkey_t *skeys;													\
+		khval_t *svals = 0;												\
+		size_t *cnt, j, nb;												\
+		int ret;														\
+		if (n == 0) return;												\
+		kh_reserve_##name(h, h->size + n);								\
+		nb = (h->n_buckets >> __ac_BUILD_SHIFT) + 1;					\
+		k = (khidx_t*)malloc(n * sizeof(khidx_t));						\
+		sk = (khidx_t*)malloc(n * sizeof(khidx_t));						\
+		skeys = (khkey_t*)malloc(n * sizeof(khkey_t));					\
+		if (kh_is_map && vals) svals = (khval_t*)malloc(n * sizeof(khval_t)); \
+		cnt = (size_t*)calloc(nb + 1, sizeof(size_t));					\
+		for (j = 0; j < n; ++j) { /* first pass: hash and count keys per block of buckets */ \
+			k[j] = __ac_##__policy##_hash(__hash_func(keys[j]));		\
+			++cnt[(__ac_##__policy##_first(k[j], h->n_buckets) >> __ac_BUILD_SHIFT) + 1]; \
+		}																\
+		for (j = 1; j <= nb; ++j) cnt[j] += cnt[j-1];					\
+		for (j = 0; j < n; ++j) { /* stable, so that the last value of a key wins */ \
+			size_t l = cnt[__ac_##__policy##_first(k[j], h->n_buckets) >> __ac_BUILD_SHIFT]++; \
+			sk[l] = k[j], skeys[l] = keys[j];							\
+			if (svals) svals[l] = vals[j];								\
+		}																\
+		free(k); free(cnt);												\
+		for (j = 0; j < n; ++j) { /* second pass: insert in bucket order */ \
+			x = kh_put_hashed_##name(h, skeys[j], sk[j], &ret);			\
+			if (svals) h->vals[x] = svals[j];							\
+		}																\
+		free(sk); free(skeys); free(svals);								\
+	}																	\
+	SCOPE void kh_merge_##name(kh_##name##_t *dst, const kh_##name##_t *src, khval_t (*combine)(khval_t, khval_t)) \
+	{																	\
+		khkey_t keys[__ac_BATCH_SIZE];									\
+		khidx_t iters[__ac_BATCH_SIZE], from[__ac_BATCH_SIZE], j = 0, l, m; \
+		int rets[__ac_BATCH_SIZE];										\
+		kh_reserve_##name(dst, dst->size + src->size);					\
+		while (j < src->n_buckets) {									\
+			for (m = 0; m < __ac_BATCH_SIZE && j < src->n_buckets; ++j)	\
+				if (!__ac_iseither(src->flags, j)) from[m] = j, keys[m++] = src->keys[j]; \
+			kh_put_batch_##name(dst, m, keys, iters, rets);				\
+			for (l = 0; kh_is_map && l < m; ++l) {						\
+				if (rets[l]) dst->vals[iters[l]] = src->vals[from[l]];	\
+				else if (combine) dst->vals[iters[l]] = combine(dst->vals[iters[l]], src->vals[from[l]]); \
+			}															\
+		}																\
+	}																	\
+	SCOPE void kh_del_##name(kh_##name##_t *h, khidx_t x)				\
+	{																	\
+		if (x != h->n_buckets && !__ac_iseither(h->flags, x)) {			\
+			__ac_set_isdel_true(h->flags, x);							\
+			--h->size;													\
+			__ac_stat(++h->stats.n_del;)								\
+		}																\
+	}
+
+#define KHASH_INIT2(name, SCOPE, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
+	__KHASH_IMPL(name, SCOPE, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal, prime, khint_t)
+
+#define KHASH_INIT(name, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
+	KHASH_INIT2(name, static inline, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal)
+
+/*! @function
+  @abstract     Instantiate kh_put_str_intern() for a table with const char* keys
+  @param  name  Name of the hash table [symbol]
+  @param  SCOPE Scope of the function [static inline]
+ */
+#define KHASH_INTERN_INIT2(name, SCOPE)									\
+	SCOPE khint_t kh_put_str_intern_##name(kh_##name##_t *h, const char *key, int *ret) \
+	{																	\
+		khint_t k = kh_put_##name(h, key, ret);							\
+		if (*ret) {														\
+			size_t l = strlen(key) + 1;									\
+			char *s = __ac_arena_alloc(&h->arena, l);					\
+			memcpy(s, key, l);											\
+			h->keys[k] = s;												\
+		}																\
+		return k;														\
+	}
+
+#define KHASH_INTERN_INIT(name) KHASH_INTERN_INIT2(name, static inline)
+
+/*! @function
+  @abstract     Instantiate kh_sso_put() for a table with kh_sso_key_t keys
+  @param  name  Name of the hash table [symbol]
+  @param  SCOPE Scope of the function [static inline]
+ */
+#define KHASH_SSO_INIT2(name, SCOPE)									\
+	SCOPE khint_t kh_sso_put_##name(kh_##name##_t *h, const char *p, khint32_t len, int *ret) \
+	{																	\
+		khint_t k = kh_put_##name(h, kh_sso(p, len), ret);				\
+		if (*ret && len > __ac_SSO_MAX) {								\
+			char *s = __ac_arena_alloc(&h->arena, len + 1);				\
+			memcpy(s, p, len);											\
+			s[len] = 0;													\
+			h->keys[k].l.p = s;											\
+		}																\
+		return k;														\
+	}
+
+#define KHASH_SSO_INIT(name) KHASH_SSO_INIT2(name, static inline)
+
+#define KHASH_INIT2_POW2(name, SCOPE, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
+	__KHASH_IMPL(name, SCOPE, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal, pow2, khint_t)
+
+#define KHASH_INIT_POW2(name, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
+	KHASH_INIT2_POW2(name, static inline, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal)
+
+/*
+  KHASH_INIT2_64 instantiates a table whose n_buckets, size, n_occupied and
+  upper_bound are 64-bit, so that it may hold more than 2^32 elements. It
+  uses the pow2 policy and expects a 64-bit hash function such as
+  kh_int64_hash_func64() or kh_str_hash_func64(). Iterators are khint64_t
+  (khiter64_t); apart from that the interface is the same as KHASH_INIT2,
+  and a KHASH_*_INIT_* user migrates by switching to KHASH64_*_INIT_*.
+  Only the table header grows; flags, keys and values take the same space.
+ */
+#define KHASH_INIT2_64(name, SCOPE, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
+	__KHASH_IMPL(name, SCOPE, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal, pow2_64, khint64_t)
+
+#define KHASH_INIT_64(name, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
+	KHASH_INIT2_64(name, static inline, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal)
+
+/* --- BEGIN OF GROUP-PROBING TABLES --- */
+
+/*
+  A table instantiated with KHASH_INIT2_SWISS keeps one control byte per
+  bucket instead of two flag bits. An occupied bucket stores the low 7 bits
+  of the (mixed) hash; empty and deleted buckets have the top bit set.
+  Buckets are probed in aligned groups of 16, and a whole group is tested
+  against the tag with one SSE2 compare, so keys are only touched on tag
+  matches and a miss usually ends in the first group. The number of buckets
+  is a power of 2 and groups are visited in triangular order.
+
+  The interface is the same as KHASH_INIT2 except that kh_exist() must be
+  replaced by kh_exist_swiss().
+ */
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define __AC_SWISS_SSE2
+#endif
+
+typedef unsigned char khint8_t;
+
+#define __ac_SWISS_GROUP 16
+#define __ac_CTRL_EMPTY 0x80
+#define __ac_CTRL_DEL 0xfe
+
+static const double __ac_SWISS_UPPER = 0.875;
+
+static inline int __ac_ctz32(khint32_t x)
+{
+#if defined(__GNUC__)
+	return __builtin_ctz(x);
+#else
+	int n = 0;
+	while (!(x & 1)) x >>= 1, ++n;
+	return n;
+#endif
+}
+
+/* bit i of the result is set if g[i] == c */
+static inline khint32_t __ac_ctrl_match(const khint8_t *g, khint8_t c)
+{
+#ifdef __AC_SWISS_SSE2
+	return (khint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char)c), _mm_loadu_si128((const __m128i*)g)));
+#else
+	khint32_t i, m = 0;
+	for (i = 0; i < __ac_SWISS_GROUP; ++i)
+		m |= (khint32_t)(g[i] == c) << i;
+	return m;
+#endif
+}
+
+/* bit i of the result is set if g[i] is empty or deleted */
+static inline khint32_t __ac_ctrl_avail(const khint8_t *g)
+{
+#ifdef __AC_SWISS_SSE2
+	return (khint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)g));
+#else
+	khint32_t i, m = 0;
+	for (i = 0; i < __ac_SWISS_GROUP; ++i)
+		m |= (khint32_t)(g[i] >> 7) << i;
+	return m;
+#endif
+}
+
+#define KHASH_INIT2_SWISS(name, SCOPE, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
+	typedef struct {													\
+		khint_t n_buckets, size, n_occupied, upper_bound;				\
+		khint8_t *ctrl;													\
+		khkey_t *keys;													\
+		khval_t *vals;													\
+	} kh_##name##_t;													\
+	SCOPE kh_##name##_t *kh_init_##name() {								\
+		return (kh_##name##_t*)calloc(1, sizeof(kh_##name##_t));		\
+	}																	\
+	SCOPE void kh_destroy_##name(kh_##name##_t *h)						\
+	{																	\
+		if (h) {														\
+			free(h->keys); free(h->ctrl);								\
+			free(h->vals);												\
+			free(h);													\
+		}																\
+	}																	\
+	SCOPE void kh_clear_##name(kh_##name##_t *h)						\
+	{																	\
+		if (h && h->ctrl) {												\
+			memset(h->ctrl, __ac_CTRL_EMPTY, h->n_buckets);				\
+			h->size = h->n_occupied = 0;								\
+		}																\
+	}																	\
+	SCOPE khint_t kh_get_##name(const kh_##name##_t *h, khkey_t key) 	\
+	{																	\
+		if (h->n_buckets) {												\
+			khint_t k, g, step = 0, mask = (h->n_buckets >> 4) - 1;		\
+			khint8_t h2;												\
+			k = __ac_fmix32(__hash_func(key)); h2 = k & 0x7f; g = (k >> 7) & mask; \
+			while (1) {													\
+				const khint8_t *c = h->ctrl + (g << 4);					\
+				khint32_t m = __ac_ctrl_match(c, h2);					\
+				while (m) {												\
+					khint_t i = (g << 4) + __ac_ctz32(m);				\
+					if (__hash_equal(h->keys[i], key)) return i;		\
+					m &= m - 1;											\
+				}														\
+				if (__ac_ctrl_match(c, __ac_CTRL_EMPTY)) return h->n_buckets; \
+				if (++step > mask) return h->n_buckets;					\
+				g = (g + step) & mask;									\
+			}															\
+		} else return 0;												\
+	}																	\
+	SCOPE void kh_resize_##name(kh_##name##_t *h, khint_t new_n_buckets) \
+	{																	\
+		khint8_t *new_ctrl;												\
+		khkey_t *new_keys;												\
+		khval_t *new_vals = 0;											\
+		khint_t j, mask;												\
+		{																\
+			khint_t t = __ac_SWISS_GROUP;								\
+			while (t < new_n_buckets) t <<= 1;							\
+			new_n_buckets = t;											\
+			if (h->size >= (khint_t)(new_n_buckets * __ac_SWISS_UPPER + 0.5)) return; \
+		}																\
+		new_ctrl = (khint8_t*)malloc(new_n_buckets);					\
+		memset(new_ctrl, __ac_CTRL_EMPTY, new_n_buckets);				\
+		new_keys = (khkey_t*)malloc(new_n_buckets * sizeof(khkey_t));	\
+		if (kh_is_map) new_vals = (khval_t*)malloc(new_n_buckets * sizeof(khval_t)); \
+		mask = (new_n_buckets >> 4) - 1;								\
+		for (j = 0; j != h->n_buckets; ++j) {							\
+			if (h->ctrl[j] < __ac_CTRL_EMPTY) {							\
+				khint_t k, g, i, step = 0;								\
+				khint32_t m;											\
+				k = __ac_fmix32(__hash_func(h->keys[j])); g = (k >> 7) & mask; \
+				while ((m = __ac_ctrl_match(new_ctrl + (g << 4), __ac_CTRL_EMPTY)) == 0) \
+					g = (g + ++step) & mask;							\
+				i = (g << 4) + __ac_ctz32(m);							\
+				new_ctrl[i] = k & 0x7f;									\
+				new_keys[i] = h->keys[j];								\
+				if (kh_is_map) new_vals[i] = h->vals[j];				\
+			}															\
+		}																\
+		free(h->ctrl); free(h->keys); free(h->vals);					\
+		h->ctrl = new_ctrl; h->keys = new_keys; h->vals = new_vals;		\
+		h->n_buckets = new_n_buckets;									\
+		h->n_occupied = h->size;										\
+		h->upper_bound = (khint_t)(h->n_buckets * __ac_SWISS_UPPER + 0.5); \
+	}																	\
+	SCOPE khint_t kh_put_##name(kh_##name##_t *h, khkey_t key, int *ret) \
+	{																	\
+		khint_t k, g, x, step = 0, mask;								\
+		khint8_t h2;													\
+		if (h->n_occupied >= h->upper_bound) {							\
+			if (h->n_buckets > (h->size<<1)) kh_resize_##name(h, h->n_buckets); \
+			else kh_resize_##name(h, h->n_buckets + 1);					\
+		}																\
+		mask = (h->n_buckets >> 4) - 1; x = h->n_buckets;				\
+		k = __ac_fmix32(__hash_func(key)); h2 = k & 0x7f; g = (k >> 7) & mask; \
+		while (1) {														\
+			const khint8_t *c = h->ctrl + (g << 4);						\
+			khint32_t m = __ac_ctrl_match(c, h2);						\
+			while (m) {													\
+				khint_t i = (g << 4) + __ac_ctz32(m);					\
+				if (__hash_equal(h->keys[i], key)) { *ret = 0; return i; } \
+				m &= m - 1;												\
+			}															\
+			if (x == h->n_buckets && (m = __ac_ctrl_avail(c)) != 0)		\
+				x = (g << 4) + __ac_ctz32(m);							\
+			if (__ac_ctrl_match(c, __ac_CTRL_EMPTY)) break;				\
+			if (++step > mask) break;									\
+			g = (g + step) & mask;										\
+		}																\
+		if (h->ctrl[x] == __ac_CTRL_EMPTY) {							\
+			++h->n_occupied;											\
+			*ret = 1;													\
+		} else *ret = 2;												\
+		h->ctrl[x] = h2;												\
+		h->keys[x] = key;												\
+		++h->size;														\
+		return x;														\
+	}																	\
+	SCOPE void kh_del_##name(kh_##name##_t *h, khint_t x)				\
+	{																	\
+		if (x != h->n_buckets && h->ctrl[x] < __ac_CTRL_EMPTY) {		\
+			if (__ac_ctrl_match(h->ctrl + (x & ~(khint_t)0xf), __ac_CTRL_EMPTY)) { \
+				h->ctrl[x] = __ac_CTRL_EMPTY;							\
+				--h->n_occupied;										\
+			} else h->ctrl[x] = __ac_CTRL_DEL;							\
+			--h->size;													\
+		}																\
+	}
+
+#define KHASH_INIT_SWISS(name, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
+	KHASH_INIT2_SWISS(name, static inline, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal)
+
+/* --- END OF GROUP-PROBING TABLES --- */
+
+/* --- BEGIN OF INCREMENTALLY RESIZED TABLES --- */
+
+/*
+  A table instantiated with KHASH_INIT2_INCR never rehashes all its keys at
+  once. When it has to grow, kh_put() allocates the new bucket arrays and
+  keeps the old ones alongside; every subsequent kh_put() and kh_get() then
+  moves the live keys of the next __ac_INCR_STEPS old buckets to the new
+  arrays. A key found in the old arrays is moved on the spot, so iterators
+  always refer to the new arrays and kh_key(), kh_val(), kh_exist() and
+  kh_del() work as usual. The bucket count is a power of 2 (pow2 policy).
+
+  As kh_get() may move keys, it takes a non-const table. Call
+  kh_resize_finish() before iterating from kh_begin() to kh_end(); until
+  then, keys not yet moved are only reachable through kh_get()/kh_put().
+ */
+
+#define __ac_INCR_STEPS 8
+
+#define KHASH_INIT2_INCR(name, SCOPE, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
+	typedef struct {													\
+		khint_t n_buckets, size, n_occupied, upper_bound;				\
+		khint32_t *flags;												\
+		khkey_t *keys;													\
+		khval_t *vals;													\
+		khint_t o_n_buckets, o_size, o_pos;								\
+		khint32_t *o_flags;												\
+		khkey_t *o_keys;												\
+		khval_t *o_vals;												\
+	} kh_##name##_t;													\
+	SCOPE kh_##name##_t *kh_init_##name() {								\
+		return (kh_##name##_t*)calloc(1, sizeof(kh_##name##_t));		\
+	}																	\
+	SCOPE void kh_destroy_##name(kh_##name##_t *h)						\
+	{																	\
+		if (h) {														\
+			free(h->keys); free(h->flags);								\
+			free(h->vals);												\
+			free(h->o_keys); free(h->o_flags);							\
+			free(h->o_vals);											\
+			free(h);													\
+		}																\
+	}																	\
+	SCOPE void kh_clear_##name(kh_##name##_t *h)						\
+	{																	\
+		if (h && h->flags) {											\
+			free(h->o_keys); free(h->o_flags); free(h->o_vals);			\
+			h->o_keys = 0; h->o_flags = 0; h->o_vals = 0;				\
+			h->o_n_buckets = h->o_size = h->o_pos = 0;					\
+			memset(h->flags, 0xaa, ((h->n_buckets>>4) + 1) * sizeof(khint32_t)); \
+			h->size = h->n_occupied = 0;								\
+		}																\
+	}																	\
+	SCOPE khint_t kh_find_##name(const khint32_t *flags, const khkey_t *keys, khint_t n_buckets, khkey_t key, khint_t k) \
+	{																	\
+		khint_t i, inc = 0;												\
+		i = k & (n_buckets - 1);										\
+		while (!__ac_isempty(flags, i) && (__ac_isdel(flags, i) || !__hash_equal(keys[i], key))) { \
+			__ac_pow2_next(n_buckets, i, inc);							\
+			if (inc >= n_buckets) return n_buckets;						\
+		}																\
+		return __ac_iseither(flags, i)? n_buckets : i;					\
+	}																	\
+	SCOPE khint_t kh_move_##name(kh_##name##_t *h, khint_t j)			\
+	{																	\
+		khint_t i, inc = 0;												\
+		i = __ac_fmix32(__hash_func(h->o_keys[j])) & (h->n_buckets - 1); \
+		while (!__ac_iseither(h->flags, i))								\
+			__ac_pow2_next(h->n_buckets, i, inc);						\
+		if (__ac_isempty(h->flags, i)) ++h->n_occupied;					\
+		__ac_set_isboth_false(h->flags, i);								\
+		h->keys[i] = h->o_keys[j];										\
+		if (kh_is_map) h->vals[i] = h->o_vals[j];						\
+		__ac_set_isdel_true(h->o_flags, j);								\
+		--h->o_size;													\
+		return i;														\
+	}																	\
+	SCOPE void kh_migrate_##name(kh_##name##_t *h, khint_t n_steps)	\
+	{																	\
+		khint_t end = h->o_n_buckets - h->o_pos > n_steps? h->o_pos + n_steps : h->o_n_buckets; \
+		for (; h->o_pos < end && h->o_size; ++h->o_pos)					\
+			if (!__ac_iseither(h->o_flags, h->o_pos))					\
+				kh_move_##name(h, h->o_pos);							\
+		if (h->o_pos == h->o_n_buckets || h->o_size == 0) {				\
+			free(h->o_keys); free(h->o_flags); free(h->o_vals);			\
+			h->o_keys = 0; h->o_flags = 0; h->o_vals = 0;				\
+			h->o_n_buckets = h->o_size = h->o_pos = 0;					\
+		}																\
+	}																	\
+	SCOPE void kh_resize_finish_##name(kh_##name##_t *h)				\
+	{																	\
+		if (h->o_n_buckets) kh_migrate_##name(h, h->o_n_buckets);		\
+	}																	\
+	SCOPE void kh_resize_begin_##name(kh_##name##_t *h, khint_t new_n_buckets) \
+	{																	\
+		kh_resize_finish_##name(h);										\
+		new_n_buckets = __ac_pow2_size(new_n_buckets);					\
+		if (h->size >= (khint_t)(new_n_buckets * __ac_HASH_UPPER + 0.5)) return; \
+		h->o_flags = h->flags; h->o_keys = h->keys; h->o_vals = h->vals; \
+		h->o_n_buckets = h->n_buckets; h->o_size = h->size; h->o_pos = 0; \
+		h->flags = (khint32_t*)malloc(((new_n_buckets>>4) + 1) * sizeof(khint32_t)); \
+		memset(h->flags, 0xaa, ((new_n_buckets>>4) + 1) * sizeof(khint32_t)); \
+		h->keys = (khkey_t*)malloc(new_n_buckets * sizeof(khkey_t));	\
+		h->vals = kh_is_map? (khval_t*)malloc(new_n_buckets * sizeof(khval_t)) : 0; \
+		h->n_buckets = new_n_buckets;									\
+		h->n_occupied = 0;												\
+		h->upper_bound = (khint_t)(h->n_buckets * __ac_HASH_UPPER + 0.5); \
+		if (h->o_size == 0) kh_migrate_##name(h, 0);					\
+	}																	\
+	SCOPE void kh_resize_##name(kh_##name##_t *h, khint_t new_n_buckets) \
+	{																	\
+		kh_resize_begin_##name(h, new_n_buckets);						\
+		kh_resize_finish_##name(h);										\
+	}																	\
+	SCOPE khint_t kh_get_##name(kh_##name##_t *h, khkey_t key)			\
+	{																	\
+		if (h->n_buckets) {												\
+			khint_t k, x;												\
+			if (h->o_n_buckets) kh_migrate_##name(h, __ac_INCR_STEPS);	\
+			k = __ac_fmix32(__hash_func(key));							\
+			x = kh_find_##name(h->flags, h->keys, h->n_buckets, key, k); \
+			if (x == h->n_buckets && h->o_n_buckets) {					\
+				khint_t j = kh_find_##name(h->o_flags, h->o_keys, h->o_n_buckets, key, k); \
+				if (j != h->o_n_buckets) x = kh_move_##name(h, j);		\
+			}															\
+			return x;													\
+		} else return 0;												\
+	}																	\
+	SCOPE khint_t kh_put_##name(kh_##name##_t *h, khkey_t key, int *ret) \
+	{																	\
+		khint_t k, i, x, inc = 0, site;									\
+		if (h->o_n_buckets) kh_migrate_##name(h, __ac_INCR_STEPS);		\
+		if (h->n_occupied >= h->upper_bound) {							\
+			if (h->n_buckets > (h->size<<1)) kh_resize_begin_##name(h, h->n_buckets - 1); \
+			else kh_resize_begin_##name(h, h->n_buckets + 1);			\
+		}																\
+		k = __ac_fmix32(__hash_func(key));								\
+		i = k & (h->n_buckets - 1); site = h->n_buckets;				\
+		while (!__ac_isempty(h->flags, i) && (__ac_isdel(h->flags, i) || !__hash_equal(h->keys[i], key))) { \
+			if (__ac_isdel(h->flags, i) && site == h->n_buckets) site = i; \
+			__ac_pow2_next(h->n_buckets, i, inc);						\
+		}																\
+		if (!__ac_isempty(h->flags, i)) {								\
+			*ret = 0;													\
+			return i;													\
+		}																\
+		if (h->o_n_buckets) {											\
+			khint_t j = kh_find_##name(h->o_flags, h->o_keys, h->o_n_buckets, key, k); \
+			if (j != h->o_n_buckets) {									\
+				*ret = 0;												\
+				return kh_move_##name(h, j);							\
+			}															\
+		}																\
+		x = site != h->n_buckets? site : i;								\
+		if (__ac_isempty(h->flags, x)) {								\
+			++h->n_occupied;											\
+			*ret = 1;													\
+		} else *ret = 2;												\
+		h->keys[x] = key;												\
+		__ac_set_isboth_false(h->flags, x);								\
+		++h->size;														\
+		return x;														\
+	}																	\
+	SCOPE void kh_del_##name(kh_##name##_t *h, khint_t x)				\
+	{																	\
+		if (x != h->n_buckets && !__ac_iseither(h->flags, x)) {			\
+			__ac_set_isdel_true(h->flags, x);							\
+			--h->size;													\
+		}																\
+	}
+
+#define KHASH_INIT_INCR(name, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
+	KHASH_INIT2_INCR(name, static inline, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal)
+
+/* --- END OF INCREMENTALLY RESIZED TABLES --- */
+
+/* --- BEGIN OF LINEAR-PROBING TABLES --- */
+
+/*
+  A table instantiated with KHASH_INIT2_LP uses a power-of-2 number of
+  buckets and linear probing. kh_del() leaves no tombstone: it shifts the
+  following keys of the cluster back into the freed bucket, so the table
+  never accumulates deleted buckets and n_occupied always equals size. This
+  suits workloads with steady insert/delete churn.
+
+  The interface is the same as KHASH_INIT2 and the bucket flags have the
+  same layout, so kh_exist() works. As kh_del() moves other keys, it
+  invalidates iterators other than the deleted one; when deleting while
+  iterating, examine bucket x again after kh_del(h, x).
+ */
+
+#define KHASH_INIT2_LP(name, SCOPE, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
+	typedef struct {													\
+		khint_t n_buckets, size, n_occupied, upper_bound;				\
+		khint32_t *flags;												\
+		khkey_t *keys;													\
+		khval_t *vals;													\
+	} kh_##name##_t;													\
+	SCOPE kh_##name##_t *kh_init_##name() {								\
+		return (kh_##name##_t*)calloc(1, sizeof(kh_##name##_t));		\
+	}																	\
+	SCOPE void kh_destroy_##name(kh_##name##_t *h)						\
+	{																	\
+		if (h) {														\
+			free(h->keys); free(h->flags);								\
+			free(h->vals);												\
+			free(h);													\
+		}																\
+	}																	\
+	SCOPE void kh_clear_##name(kh_##name##_t *h)						\
+	{																	\
+		if (h && h->flags) {											\
+			memset(h->flags, 0xaa, ((h->n_buckets>>4) + 1) * sizeof(khint32_t)); \
+			h->size = h->n_occupied = 0;								\
+		}																\
+	}																	\
+	SCOPE khint_t kh_get_##name(const kh_##name##_t *h, khkey_t key) 	\
+	{																	\
+		if (h->n_buckets) {												\
+			khint_t i, n = 0, mask = h->n_buckets - 1;					\
+			i = __ac_fmix32(__hash_func(key)) & mask;					\
+			while (!__ac_isempty(h->flags, i) && !__hash_equal(h->keys[i], key)) { \
+				i = (i + 1) & mask;										\
+				if (++n == h->n_buckets) return h->n_buckets;			\
+			}															\
+			return __ac_isempty(h->flags, i)? h->n_buckets : i;			\
+		} else return 0;												\
+	}																	\
+	SCOPE void kh_resize_##name(kh_##name##_t *h, khint_t new_n_buckets) \
+	{																	\
+		khint32_t *new_flags;											\
+		khint_t j, new_mask;											\
+		new_n_buckets = __ac_pow2_size(new_n_buckets);					\
+		if (h->size >= (khint_t)(new_n_buckets * __ac_HASH_UPPER + 0.5)) return; \
+		new_flags = (khint32_t*)malloc(((new_n_buckets>>4) + 1) * sizeof(khint32_t)); \
+		memset(new_flags, 0xaa, ((new_n_buckets>>4) + 1) * sizeof(khint32_t)); \
+		if (h->n_buckets < new_n_buckets) {								\
+			h->keys = (khkey_t*)realloc(h->keys, new_n_buckets * sizeof(khkey_t)); \
+			if (kh_is_map)												\
+				h->vals = (khval_t*)realloc(h->vals, new_n_buckets * sizeof(khval_t)); \
+		}																\
+		new_mask = new_n_buckets - 1;									\
+		for (j = 0; j != h->n_buckets; ++j) {							\
+			if (__ac_iseither(h->flags, j) == 0) {						\
+				khkey_t key = h->keys[j];								\
+				khval_t val;											\
+				if (kh_is_map) val = h->vals[j];						\
+				__ac_set_isdel_true(h->flags, j);						\
+				while (1) {												\
+					khint_t i = __ac_fmix32(__hash_func(key)) & new_mask; \
+					while (!__ac_isempty(new_flags, i)) i = (i + 1) & new_mask; \
+					__ac_set_isempty_false(new_flags, i);				\
+					if (i < h->n_buckets && __ac_iseither(h->flags, i) == 0) { \
+						{ khkey_t tmp = h->keys[i]; h->keys[i] = key; key = tmp; } \
+						if (kh_is_map) { khval_t tmp = h->vals[i]; h->vals[i] = val; val = tmp; } \
+						__ac_set_isdel_true(h->flags, i);				\
+					} else {											\
+						h->keys[i] = key;								\
+						if (kh_is_map) h->vals[i] = val;				\
+						break;											\
+					}													\
+				}														\
+			}															\
+		}																\
+		if (h->n_buckets > new_n_buckets) {								\
+			h->keys = (khkey_t*)realloc(h->keys, new_n_buckets * sizeof(khkey_t)); \
+			if (kh_is_map)												\
+				h->vals = (khval_t*)realloc(h->vals, new_n_buckets * sizeof(khval_t)); \
+		}																\
+		free(h->flags);													\
+		h->flags = new_flags;											\
+		h->n_buckets = new_n_buckets;									\
+		h->n_occupied = h->size;										\
+		h->upper_bound = (khint_t)(h->n_buckets * __ac_HASH_UPPER + 0.5); \
+	}																	\
+	SCOPE khint_t kh_put_##name(kh_##name##_t *h, khkey_t key, int *ret) \
+	{																	\
+		khint_t i, mask;												\
+		if (h->size >= h->upper_bound)									\
+			kh_resize_##name(h, h->n_buckets + 1);						\
+		mask = h->n_buckets - 1;										\
+		i = __ac_fmix32(__hash_func(key)) & mask;						\
+		while (!__ac_isempty(h->flags, i) && !__hash_equal(h->keys[i], key)) \
+			i = (i + 1) & mask;											\
+		if (__ac_isempty(h->flags, i)) {								\
+			h->keys[i] = key;											\
+			__ac_set_isboth_false(h->flags, i);							\
+			++h->size; ++h->n_occupied;									\
+			*ret = 1;													\
+		} else *ret = 0;												\
+		return i;														\
+	}																	\
+	SCOPE void kh_del_##name(kh_##name##_t *h, khint_t i)				\
+	{																	\
+		khint_t j, k, mask = h->n_buckets - 1;							\
+		if (i == h->n_buckets || __ac_iseither(h->flags, i)) return;	\
+		for (j = (i + 1) & mask; !__ac_isempty(h->flags, j); j = (j + 1) & mask) { \
+			k = __ac_fmix32(__hash_func(h->keys[j])) & mask;			\
+			if ((j > i && (k <= i || k > j)) || (j < i && k <= i && k > j)) { \
+				h->keys[i] = h->keys[j];								\
+				if (kh_is_map) h->vals[i] = h->vals[j];					\
+				i = j;													\
+			}															\
+		}																\
+		__ac_set_isempty_true(h->flags, i);								\
+		--h->size; --h->n_occupied;										\
+	}
+
+#define KHASH_INIT_LP(name, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
+	KHASH_INIT2_LP(name, static inline, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal)
+
+/* --- END OF LINEAR-PROBING TABLES --- */
+
+/* --- BEGIN OF ROBIN HOOD TABLES --- */
+
+/*
+  A table instantiated with KHASH_INIT2_RH uses linear probing over a
+  power-of-2 number of buckets with Robin Hood insertion: a key being
+  inserted takes the bucket of any key that is closer to its own home
+  bucket. Each bucket stores its probe distance plus one in a byte of
+  dist[] (0 for empty), so a lookup stops as soon as it meets a bucket
+  whose key is closer to home than the probe, and only compares keys
+  stored at the same distance. Probe lengths stay short and even at a
+  maximum load of 0.9; a probe distance reaching __ac_RH_MAX forces the
+  table to grow. Deletion shifts the following keys back.
+
+  Growing does not shorten the probe of keys sharing one hash, so at most
+  __ac_RH_MAX-1 of them fit. When a key cannot be placed after
+  __ac_RH_GROW doublings, or without taking the load below 1/64,
+  kh_put() sets *ret to -1, returns kh_end() and leaves the table
+  unchanged, so colliding keys cannot make it grow without bound.
+
+  The interface is the same as KHASH_INIT2 except that kh_exist() must be
+  replaced by kh_exist_rh(). kh_put() and kh_del() may move other keys.
+ */
+
+#define __ac_RH_MAX 255
+#define __ac_RH_GROW 3 /* doublings tried before giving up on a too long probe */
+#define __ac_RH_SPARSE 64 /* nor is a table grown for it below a load of 1/64 */
+
+static const double __ac_RH_UPPER = 0.9;
+
+#define KHASH_INIT2_RH(name, SCOPE, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
+	typedef struct {													\
+		khint_t n_buckets, size, n_occupied, upper_bound;				\
+		khint8_t *dist;													\
+		khkey_t *keys;													\
+		khval_t *vals;													\
+	} kh_##name##_t;													\
+	SCOPE kh_##name##_t *kh_init_##name() {								\
+		return (kh_##name##_t*)calloc(1, sizeof(kh_##name##_t));		\
+	}																	\
+	SCOPE void kh_destroy_##name(kh_##name##_t *h)						\
+	{																	\
+		if (h) {														\
+			free(h->keys); free(h->dist);								\
+			free(h->vals);												\
+			free(h);													\
+		}																\
+	}																	\
+	SCOPE void kh_clear_##name(kh_##name##_t *h)						\
+	{																	\
+		if (h && h->dist) {												\
+			memset(h->dist, 0, h->n_buckets);							\
+			h->size = h->n_occupied = 0;								\
+		}																\
+	}																	\
+	SCOPE khint_t kh_get_##name(const kh_##name##_t *h, khkey_t key) 	\
+	{																	\
+		if (h->n_buckets) {												\
+			khint_t i, d, mask = h->n_buckets - 1;						\
+			i = __ac_fmix32(__hash_func(key)) & mask;					\
+			for (d = 1; d < __ac_RH_MAX && h->dist[i] >= d; ++d, i = (i + 1) & mask) \
+				if (h->dist[i] == d && __hash_equal(h->keys[i], key)) return i; \
+			return h->n_buckets;										\
+		} else return 0;												\
+	}																	\
+	SCOPE int kh_place_##name(khint8_t *dist, khkey_t *keys, khval_t *vals, khint_t mask, khint_t i, khint_t d, khkey_t *key, khval_t *val) \
+	{ /* insert an absent key at distance d-1 in bucket i or later; if a probe distance overflows, return 0 with the key left out in *key and *val */ \
+		for (; d < __ac_RH_MAX; ++d, i = (i + 1) & mask) {				\
+			if (dist[i] == 0) {											\
+				dist[i] = d; keys[i] = *key;							\
+				if (kh_is_map) vals[i] = *val;							\
+				return 1;												\
+			}															\
+			if (dist[i] < d) {											\
+				{ khkey_t tmp = keys[i]; keys[i] = *key; *key = tmp; }	\
+				if (kh_is_map) { khval_t tmp = vals[i]; vals[i] = *val; *val = tmp; } \
+				{ khint_t tmp = dist[i]; dist[i] = d; d = tmp; }		\
+			}															\
+		}																\
+		return 0;														\
+	}																	\
+	SCOPE int kh_can_place_##name(const khint8_t *dist, khint_t mask, khint_t i, khint_t d) \
+	{ /* whether kh_place() from bucket i at distance d-1 would succeed; nothing is moved */ \
+		for (; d < __ac_RH_MAX; ++d, i = (i + 1) & mask) {				\
+			if (dist[i] == 0) return 1;									\
+			if (dist[i] < d) d = dist[i];								\
+		}																\
+		return 0;														\
+	}																	\
+	SCOPE int kh_resize_##name(kh_##name##_t *h, khint_t new_n_buckets)	\
+	{ /* return -1 if the keys cannot be placed even after __ac_RH_GROW doublings; h is then unchanged */ \
+		khint8_t *new_dist;												\
+		khkey_t *new_keys;												\
+		khval_t *new_vals = 0;											\
+		khint_t j;														\
+		int n_retry = 0;												\
+		new_n_buckets = __ac_pow2_size(new_n_buckets);					\
+		if (h->size >= (khint_t)(new_n_buckets * __ac_RH_UPPER + 0.5)) return 0; \
+	retry:																\
+		new_dist = (khint8_t*)calloc(new_n_buckets, 1);					\
+		new_keys = (khkey_t*)malloc(new_n_buckets * sizeof(khkey_t));	\
+		if (kh_is_map) new_vals = (khval_t*)malloc(new_n_buckets * sizeof(khval_t)); \
+		for (j = 0; j != h->n_buckets; ++j) {							\
+			if (h->dist[j]) {											\
+				khint_t mask = new_n_buckets - 1;						\
+				khkey_t key = h->keys[j];								\
+				khval_t val;											\
+				if (kh_is_map) val = h->vals[j];						\
+				if (!kh_place_##name(new_dist, new_keys, new_vals, mask, __ac_fmix32(__hash_func(key)) & mask, 1, &key, &val)) { \
+					free(new_dist); free(new_keys); free(new_vals);		\
+					if (++n_retry > __ac_RH_GROW || new_n_buckets >= 0x80000000U) return -1; \
+					new_n_buckets <<= 1;								\
+					goto retry;											\
+				}														\
+			}															\
+		}																\
+		free(h->dist); free(h->keys); free(h->vals);					\
+		h->dist = new_dist; h->keys = new_keys; h->vals = new_vals;		\
+		h->n_buckets = new_n_buckets;									\
+		h->n_occupied = h->size;										\
+		h->upper_bound = (khint_t)(h->n_buckets * __ac_RH_UPPER + 0.5);	\
+		return 0;														\
+	}																	\
+	SCOPE khint_t kh_put_##name(kh_##name##_t *h, khkey_t key, int *ret) \
+	{																	\
+		khint_t i, d, mask;												\
+		khval_t v;														\
+		int n_grow = 0;													\
+		if (h->size >= h->upper_bound && kh_resize_##name(h, h->n_buckets + 1) < 0) { \
+			*ret = -1;													\
+			return h->n_buckets;										\
+		}																\
+		for (;;) {														\
+			mask = h->n_buckets - 1;									\
+			i = __ac_fmix32(__hash_func(key)) & mask;					\
+			for (d = 1; d < __ac_RH_MAX && h->dist[i] >= d; ++d, i = (i + 1) & mask) \
+				if (h->dist[i] == d && __hash_equal(h->keys[i], key)) {	\
+					*ret = 0;											\
+					return i;											\
+				}														\
+			if (d < __ac_RH_MAX && kh_can_place_##name(h->dist, mask, i, d)) break; \
+			/* too long a probe for the key or a key it displaces; grow, unless that does not help */ \
+			if (++n_grow > __ac_RH_GROW || h->size < h->n_buckets / __ac_RH_SPARSE || kh_resize_##name(h, h->n_buckets + 1) < 0) { \
+				*ret = -1;												\
+				return h->n_buckets;									\
+			}															\
+		}																\
+		memset(&v, 0, sizeof(khval_t));									\
+		kh_place_##name(h->dist, h->keys, h->vals, mask, i, d, &key, &v); /* lands in bucket i */ \
+		++h->size; ++h->n_occupied;										\
+		*ret = 1;														\
+		return i;														\
+	}																	\
+	SCOPE void kh_del_##name(kh_##name##_t *h, khint_t i)				\
+	{																	\
+		khint_t j, mask = h->n_buckets - 1;								\
+		if (i == h->n_buckets || h->dist[i] == 0) return;				\
+		for (j = (i + 1) & mask; h->dist[j] > 1; i = j, j = (j + 1) & mask) { \
+			h->keys[i] = h->keys[j];									\
+			if (kh_is_map) h->vals[i] = h->vals[j];						\
+			h->dist[i] = h->dist[j] - 1;								\
+		}																\
+		h->dist[i] = 0;													\
+		--h->size; --h->n_occupied;										\
+	}
+
+#define KHASH_INIT_RH(name, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
+	KHASH_INIT2_RH(name, static inline, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal)
+
+/* --- END OF ROBIN HOOD TABLES --- */
+
+/* --- BEGIN OF INTERLEAVED TABLES --- */
+
+/*
+  A table instantiated with KHASH_INIT2_AOS stores an array of buckets, each
+  holding a key, its value and a one-byte flag, instead of separate flags,
+  keys and values arrays. A lookup that finds its key at the first probe
+  then touches a single cache line, which pays off for maps with small
+  values such as counters. The flag is kept in the bucket rather than in a
+  bit array, as a separate array would bring back a second miss. Bucket
+  counts are powers of 2 and probing is triangular, as with
+  KHASH_INIT2_POW2.
+
+  The interface is the same as KHASH_INIT2 except that kh_exist(), kh_key()
+  and kh_val() must be replaced by kh_exist_aos(), kh_key_aos() and
+  kh_val_aos().
+ */
+
+#define __ac_AOS_EMPTY 0
+#define __ac_AOS_FULL 1
+#define __ac_AOS_DEL 2
+
+#define KHASH_INIT2_AOS(name, SCOPE, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
+	typedef struct {													\
+		khkey_t key;													\
+		khval_t val;													\
+		khint8_t flag;													\
+	} kh_##name##_bucket_t;												\
+	typedef struct {													\
+		khint_t n_buckets, size, n_occupied, upper_bound;				\
+		kh_##name##_bucket_t *buckets;									\
+	} kh_##name##_t;													\
+	SCOPE kh_##name##_t *kh_init_##name() {								\
+		return (kh_##name##_t*)calloc(1, sizeof(kh_##name##_t));		\
+	}																	\
+	SCOPE void kh_destroy_##name(kh_##name##_t *h)						\
+	{																	\
+		if (h) {														\
+			free(h->buckets);											\
+			free(h);													\
+		}																\
+	}																	\
+	SCOPE void kh_clear_##name(kh_##name##_t *h)						\
+	{																	\
+		if (h && h->buckets) {											\
+			memset(h->buckets, 0, h->n_buckets * sizeof(kh_##name##_bucket_t)); \
+			h->size = h->n_occupied = 0;								\
+		}																\
+	}																	\
+	SCOPE khint_t kh_get_##name(const kh_##name##_t *h, khkey_t key) 	\
+	{																	\
+		if (h->n_buckets) {												\
+			khint_t i, inc = 0, mask = h->n_buckets - 1;				\
+			const kh_##name##_bucket_t *b;								\
+			i = __ac_fmix32(__hash_func(key)) & mask;					\
+			for (b = &h->buckets[i]; b->flag != __ac_AOS_EMPTY; b = &h->buckets[i]) { \
+				if (b->flag == __ac_AOS_FULL && __hash_equal(b->key, key)) return i; \
+				i = (i + ++inc) & mask;									\
+				if (inc == h->n_buckets) break;							\
+			}															\
+			return h->n_buckets;										\
+		} else return 0;												\
+	}																	\
+	SCOPE void kh_resize_##name(kh_##name##_t *h, khint_t new_n_buckets) \
+	{																	\
+		kh_##name##_bucket_t *new_buckets;								\
+		khint_t j, new_mask;											\
+		new_n_buckets = __ac_pow2_size(new_n_buckets);					\
+		if (h->size >= (khint_t)(new_n_buckets * __ac_HASH_UPPER + 0.5)) return; \
+		new_buckets = (kh_##name##_bucket_t*)calloc(new_n_buckets, sizeof(kh_##name##_bucket_t)); \
+		new_mask = new_n_buckets - 1;									\
+		for (j = 0; j != h->n_buckets; ++j) {							\
+			if (h->buckets[j].flag == __ac_AOS_FULL) {					\
+				khint_t i, inc = 0;										\
+				i = __ac_fmix32(__hash_func(h->buckets[j].key)) & new_mask; \
+				while (new_buckets[i].flag != __ac_AOS_EMPTY) i = (i + ++inc) & new_mask; \
+				new_buckets[i] = h->buckets[j];							\
+			}															\
+		}																\
+		free(h->buckets);												\
+		h->buckets = new_buckets;										\
+		h->n_buckets = new_n_buckets;									\
+		h->n_occupied = h->size;										\
+		h->upper_bound = (khint_t)(h->n_buckets * __ac_HASH_UPPER + 0.5); \
+	}																	\
+	SCOPE khint_t kh_put_##name(kh_##name##_t *h, khkey_t key, int *ret) \
+	{																	\
+		khint_t i, x, inc = 0, mask;									\
+		if (h->n_occupied >= h->upper_bound) { /* update the hash table */ \
+			if (h->n_buckets > (h->size<<1)) kh_resize_##name(h, h->n_buckets - 1); /* clear "deleted" elements */ \
+			else kh_resize_##name(h, h->n_buckets + 1); /* expand the hash table */ \
+		}																\
+		mask = h->n_buckets - 1;										\
+		x = h->n_buckets;												\
+		i = __ac_fmix32(__hash_func(key)) & mask;						\
+		while (h->buckets[i].flag != __ac_AOS_EMPTY) {					\
+			if (h->buckets[i].flag == __ac_AOS_DEL) {					\
+				if (x == h->n_buckets) x = i;							\
+			} else if (__hash_equal(h->buckets[i].key, key)) {			\
+				*ret = 0;												\
+				return i;												\
+			}															\
+			i = (i + ++inc) & mask;										\
+			if (inc == h->n_buckets) break;								\
 		}																\
-		if (__ac_isempty(h->flags, x)) {								\
-			h->keys[x] = key;											\
-			__ac_set_isboth_false(h->flags, x);							\
-			++h->size; ++h->n_occupied;									\
+		if (x == h->n_buckets) { /* no deleted bucket on the way */		\
+			x = i;														\
+			++h->n_occupied;											\
 			*ret = 1;													\
-		} else if (__ac_isdel(h->flags, x)) {							\
-			h->keys[x] = key;											\
-			__ac_set_isboth_false(h->flags, x);							\
-			++h->size;													\
-			*ret = 2;													\
-		} else *ret = 0;												\
+		} else *ret = 2;												\
+		h->buckets[x].key = key;										\
+		h->buckets[x].flag = __ac_AOS_FULL;								\
+		++h->size;														\
 		return x;														\
 	}																	\
 	SCOPE void kh_del_##name(kh_##name##_t *h, khint_t x)				\
 	{																	\
-		if (x != h->n_buckets && !__ac_iseither(h->flags, x)) {			\
-			__ac_set_isdel_true(h->flags, x);							\
+		if (x != h->n_buckets && h->buckets[x].flag == __ac_AOS_FULL) {	\
+			h->buckets[x].flag = __ac_AOS_DEL;							\
 			--h->size;													\
 		}																\
 	}
 
-#define KHASH_INIT(name, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
-	KHASH_INIT2(name, static inline, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal)
+#define KHASH_INIT_AOS(name, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal) \
+	KHASH_INIT2_AOS(name, static inline, khkey_t, khval_t, kh_is_map, __hash_func, __hash_equal)
+
+/* --- END OF INTERLEAVED TABLES --- */
 
 /* --- BEGIN OF HASH FUNCTIONS --- */
 
@@ -349,6 +1792,245 @@ static inline khint_t __ac_X31_hash_string(const char *s)
   @abstract     Const char* comparison function
  */
 #define kh_str_hash_equal(a, b) (strcmp(a, b) == 0)
+/*! @abstract  const char* key with its hash value cached beside it */
+typedef struct {
+	const char *s;
+	khint32_t h;
+} kh_strh_key_t;
+/*! @function
+  @abstract     Make a kh_strh_key_t key, computing its hash once
+  @param  s     Pointer to a null terminated string [const char*]
+  @return       The key [kh_strh_key_t]
+ */
+static inline kh_strh_key_t kh_strh(const char *s)
+{
+	kh_strh_key_t k;
+	k.s = s, k.h = __ac_X31_hash_string(s);
+	return k;
+}
+/*! @function
+  @abstract     kh_strh_key_t hash function; returns the cached hash
+  @param  key   The key [kh_strh_key_t]
+  @return       The hash value [khint_t]
+ */
+#define kh_strh_hash_func(key) ((key).h)
+/*! @function
+  @abstract     kh_strh_key_t comparison function; strings are only compared
+                when the hashes are equal
+ */
+#define kh_strh_hash_equal(a, b) ((a).h == (b).h && strcmp((a).s, (b).s) == 0)
+/*! @function
+  @abstract     Integer hash function for KHASH_INIT2_64 tables
+  @param  key   The integer [khint32_t]
+  @return       The hash value [khint64_t]
+ */
+#define kh_int_hash_func64(key) (khint64_t)(key)
+/*! @function
+  @abstract     64-bit integer hash function for KHASH_INIT2_64 tables
+  @param  key   The integer [khint64_t]
+  @return       The hash value [khint64_t]
+ */
+#define kh_int64_hash_func64(key) (khint64_t)(key)
+/*! @function
+  @abstract     64-bit const char* hash function
+  @param  s     Pointer to a null terminated string
+  @return       The hash value [khint64_t]
+ */
+static inline khint64_t __ac_X31_hash_string64(const char *s)
+{
+	khint64_t h = *s;
+	if (h) for (++s ; *s; ++s) h = (h << 5) - h + *s;
+	return h;
+}
+/*! @function
+  @abstract     const char* hash function for KHASH_INIT2_64 tables
+  @param  key   Pointer to a null terminated string [const char*]
+  @return       The hash value [khint64_t]
+ */
+#define kh_str_hash_func64(key) __ac_X31_hash_string64(key)
+
+/* The following is a port of wyhash (public domain): 8 bytes per step, three
+   independent lanes on long keys, and a length-dependent finalization. */
+#define __ac_WY_S0 0xa0761d6478bd642full
+#define __ac_WY_S1 0xe7037ed1a0b428dbull
+#define __ac_WY_S2 0x8ebc6af09c88c6e3ull
+#define __ac_WY_S3 0x589965cc75374cc3ull
+
+static inline void __ac_wymum(khint64_t *a, khint64_t *b)
+{
+#ifdef __SIZEOF_INT128__
+	__uint128_t r = (__uint128_t)*a * *b;
+	*a = (khint64_t)r, *b = (khint64_t)(r >> 64);
+#else
+	khint64_t ha = *a >> 32, hb = *b >> 32, la = (khint32_t)*a, lb = (khint32_t)*b, hi, lo;
+	khint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32), c = t < rl;
+	lo = t + (rm1 << 32), c += lo < t;
+	hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+	*a = lo, *b = hi;
+#endif
+}
+static inline khint64_t __ac_wymix(khint64_t a, khint64_t b)
+{
+	__ac_wymum(&a, &b);
+	return a ^ b;
+}
+static inline khint64_t __ac_wyr8(const unsigned char *p) { khint64_t v; memcpy(&v, p, 8); return v; }
+static inline khint64_t __ac_wyr4(const unsigned char *p) { khint32_t v; memcpy(&v, p, 4); return v; }
+static inline khint64_t __ac_wyr3(const unsigned char *p, size_t k)
+{
+	return ((khint64_t)p[0]) << 16 | ((khint64_t)p[k >> 1]) << 8 | p[k - 1];
+}
+/*! @function
+  @abstract     Word-at-a-time hash of a byte string
+  @param  key   Pointer to the bytes; need not be null terminated [const void*]
+  @param  len   Number of bytes [size_t]
+  @param  seed  Seed [khint64_t]
+  @return       The hash value [khint64_t]
+ */
+static inline khint64_t __ac_wyhash(const void *key, size_t len, khint64_t seed)
+{
+	const unsigned char *p = (const unsigned char*)key;
+	khint64_t a, b;
+	seed ^= __ac_wymix(seed ^ __ac_WY_S0, __ac_WY_S1);
+	if (len <= 16) {
+		if (len >= 4) {
+			a = __ac_wyr4(p) << 32 | __ac_wyr4(p + ((len >> 3) << 2));
+			b = __ac_wyr4(p + len - 4) << 32 | __ac_wyr4(p + len - 4 - ((len >> 3) << 2));
+		} else if (len > 0) a = __ac_wyr3(p, len), b = 0;
+		else a = b = 0;
+	} else {
+		size_t i = len;
+		if (i > 48) {
+			khint64_t see1 = seed, see2 = seed;
+			do {
+				seed = __ac_wymix(__ac_wyr8(p) ^ __ac_WY_S1, __ac_wyr8(p + 8) ^ seed);
+				see1 = __ac_wymix(__ac_wyr8(p + 16) ^ __ac_WY_S2, __ac_wyr8(p + 24) ^ see1);
+				see2 = __ac_wymix(__ac_wyr8(p + 32) ^ __ac_WY_S3, __ac_wyr8(p + 40) ^ see2);
+				p += 48, i -= 48;
+			} while (i > 48);
+			seed ^= see1 ^ see2;
+		}
+		while (i > 16) {
+			seed = __ac_wymix(__ac_wyr8(p) ^ __ac_WY_S1, __ac_wyr8(p + 8) ^ seed);
+			p += 16, i -= 16;
+		}
+		a = __ac_wyr8(p + i - 16), b = __ac_wyr8(p + i - 8);
+	}
+	a ^= __ac_WY_S1, b ^= seed;
+	__ac_wymum(&a, &b);
+	return __ac_wymix(a ^ __ac_WY_S0 ^ len, b ^ __ac_WY_S1);
+}
+/*! @function
+  @abstract     Hash function for strings of known length
+  @param  p     Pointer to the string; need not be null terminated [const char*]
+  @param  len   Length of the string [size_t]
+  @return       The hash value [khint_t]
+ */
+#define kh_strn_hash_func(p, len) ((khint_t)__ac_wyhash(p, len, 0))
+/*! @function
+  @abstract     Seeded hash function for strings of known length
+  @param  p     Pointer to the string [const char*]
+  @param  len   Length of the string [size_t]
+  @param  seed  Seed, e.g. drawn at random on startup when keys come from
+                untrusted input [khint64_t]
+  @return       The hash value [khint_t]
+  @discussion   Hash functions given to KHASH_INIT take a key only; wrap this
+                one in a macro reading the seed from a variable.
+ */
+#define kh_strn_hash_func_seed(p, len, seed) ((khint_t)__ac_wyhash(p, len, seed))
+/*! @function
+  @abstract     Hash function for strings of known length, for KHASH_INIT2_64 tables
+  @return       The hash value [khint64_t]
+ */
+#define kh_strn_hash_func64(p, len) __ac_wyhash(p, len, 0)
+/*! @abstract  String key given by a pointer and a length */
+typedef struct {
+	const char *p;
+	khint32_t len;
+} kh_sv_key_t;
+/*! @function
+  @abstract     Make a kh_sv_key_t key
+  @param  p     Pointer to the first character; need not be null terminated [const char*]
+  @param  len   Length of the string [khint32_t]
+  @return       The key [kh_sv_key_t]
+ */
+static inline kh_sv_key_t kh_sv(const char *p, khint32_t len)
+{
+	kh_sv_key_t k;
+	k.p = p, k.len = len;
+	return k;
+}
+/*! @function
+  @abstract     kh_sv_key_t hash function
+  @param  key   The key [kh_sv_key_t]
+  @return       The hash value [khint_t]
+ */
+#define kh_sv_hash_func(key) kh_strn_hash_func((key).p, (key).len)
+/*! @function
+  @abstract     kh_sv_key_t comparison function
+ */
+#define kh_sv_hash_equal(a, b) ((a).len == (b).len && memcmp((a).p, (b).p, (a).len) == 0)
+/*! @abstract  16-byte string key: strings of up to 15 bytes are stored inline
+                 and null terminated, with 15 - length in the last byte; longer
+                 ones are a pointer and a length, with the last byte set to 0xff */
+typedef union {
+	char s[16];
+	struct {
+		const char *p;
+		khint32_t len;
+	} l;
+	khint64_t w[2];
+} kh_sso_key_t;
+#define __ac_SSO_MAX 15
+#define __ac_sso_long(key) ((key).s[__ac_SSO_MAX] == (char)0xff)
+/*! @function
+  @abstract     Make a kh_sso_key_t key; a long string is referenced, not copied
+  @param  p     Pointer to the string; need not be null terminated [const char*]
+  @param  len   Length of the string [khint32_t]
+  @return       The key [kh_sso_key_t]
+ */
+static inline kh_sso_key_t kh_sso(const char *p, khint32_t len)
+{
+	kh_sso_key_t k;
+	memset(&k, 0, sizeof(kh_sso_key_t));
+	if (len <= __ac_SSO_MAX) {
+		memcpy(k.s, p, len);
+		k.s[__ac_SSO_MAX] = __ac_SSO_MAX - len;
+	} else {
+		k.l.p = p, k.l.len = len;
+		k.s[__ac_SSO_MAX] = (char)0xff;
+	}
+	return k;
+}
+/*! @function
+  @abstract     Get the characters of a kh_sso_key_t key
+  @param  key   Pointer to the key [kh_sso_key_t*]
+  @return       Pointer to the string [const char*]
+ */
+#define kh_sso_str(key) (__ac_sso_long(*(key))? (key)->l.p : (const char*)(key)->s)
+/*! @function
+  @abstract     Get the length of a kh_sso_key_t key
+  @param  key   Pointer to the key [kh_sso_key_t*]
+  @return       Length of the string [khint32_t]
+ */
+#define kh_sso_len(key) (__ac_sso_long(*(key))? (key)->l.len : (khint32_t)(__ac_SSO_MAX - (key)->s[__ac_SSO_MAX]))
+static inline khint_t __ac_sso_hash(kh_sso_key_t key)
+{
+	if (__ac_sso_long(key)) return kh_strn_hash_func(key.l.p, key.l.len);
+	return (khint_t)__ac_wymix(key.w[0] ^ __ac_WY_S0, key.w[1] ^ __ac_WY_S1);
+}
+/*! @function
+  @abstract     kh_sso_key_t hash function; short keys are hashed as two words
+  @param  key   The key [kh_sso_key_t]
+  @return       The hash value [khint_t]
+ */
+#define kh_sso_hash_func(key) __ac_sso_hash(key)
+/*! @function
+  @abstract     kh_sso_key_t comparison function; short keys are compared as two
+                words, without dereferencing any pointer
+ */
+#define kh_sso_hash_equal(a, b) (((a).w[0] == (b).w[0] && (a).w[1] == (b).w[1]) \
+	|| (__ac_sso_long(a) && __ac_sso_long(b) && (a).l.len == (b).l.len && memcmp((a).l.p, (b).l.p, (a).l.len) == 0))
 
 /* --- END OF HASH FUNCTIONS --- */
 
@@ -367,6 +2049,15 @@ static inline khint_t __ac_X31_hash_string(const char *s)
  */
 #define kh_init(name) kh_init_##name()
 
+/*! @function
+  @abstract     Set the allocator of the flags, keys and values arrays.
+  @param  h     Pointer to a KHASH_INIT2 hash table [khash_t(name)*]
+  @param  a     Pointer to the allocator, which must outlive the table;
+                NULL for malloc() [const kh_allocator_t*]
+  @discussion   Must be called before the first insertion or resize.
+ */
+#define kh_set_allocator(h, a) ((h)->alloc = (a))
+
 /*! @function
   @abstract     Destroy a hash table.
   @param  name  Name of the hash table [symbol]
@@ -389,6 +2080,13 @@ static inline khint_t __ac_X31_hash_string(const char *s)
  */
 #define kh_resize(name, h, s) kh_resize_##name(h, s)
 
+/*! @function
+  @abstract     Complete a pending incremental resize (KHASH_INIT2_INCR only).
+  @param  name  Name of the hash table [symbol]
+  @param  h     Pointer to the hash table [khash_t(name)*]
+ */
+#define kh_resize_finish(name, h) kh_resize_finish_##name(h)
+
 /*! @function
   @abstract     Insert a key to the hash table.
   @param  name  Name of the hash table [symbol]
@@ -407,9 +2105,90 @@ static inline khint_t __ac_X31_hash_string(const char *s)
   @param  h     Pointer to the hash table [khash_t(name)*]
   @param  k     Key [type of keys]
   @return       Iterator to the found element, or kh_end(h) is the element is absent [khint_t]
+  @discussion   With KH_STATS defined, kh_get() updates the statistics of h
+                through a pointer cast from const (see KH_STATS above).
  */
 #define kh_get(name, h, k) kh_get_##name(h, k)
 
+/*! @function
+  @abstract     Retrieve an array of keys from the hash table.
+  @param  name  Name of the hash table [symbol]
+  @param  h     Pointer to the hash table [khash_t(name)*]
+  @param  n     Number of keys [size_t]
+  @param  keys  Keys to look up [const type of keys*]
+  @param  iters Output: for each key, the iterator as kh_get() would return it [khint_t*]
+  @discussion   Keys are hashed and their first buckets prefetched in windows
+                of __ac_BATCH_SIZE before any of them is probed, so that the
+                cache misses of different keys overlap.
+ */
+#define kh_get_batch(name, h, n, keys, iters) kh_get_batch_##name(h, n, keys, iters)
+
+/*! @function
+  @abstract     Insert an array of keys to the hash table.
+  @param  name  Name of the hash table [symbol]
+  @param  h     Pointer to the hash table [khash_t(name)*]
+  @param  n     Number of keys [size_t]
+  @param  keys  Keys to insert [const type of keys*]
+  @param  iters Output: for each key, the iterator as kh_put() would return it [khint_t*]
+  @param  rets  Output: for each key, the return code of kh_put() [int*]
+  @discussion   Keys are inserted in order. The table is grown once up front
+                to hold n more elements, so all returned iterators are valid.
+ */
+#define kh_put_batch(name, h, n, keys, iters, rets) kh_put_batch_##name(h, n, keys, iters, rets)
+
+/*! @function
+  @abstract     Insert arrays of keys and values to the hash table.
+  @param  name  Name of the hash table [symbol]
+  @param  h     Pointer to the hash table [khash_t(name)*]
+  @param  n     Number of keys [size_t]
+  @param  keys  Keys to insert [const type of keys*]
+  @param  vals  Values of the keys, or NULL to leave values unset [const type of values*]
+  @discussion   The table is grown once; keys are then hashed, sorted by the
+                block of buckets they map to, and inserted in that order, so
+                that the table is filled front to back rather than at random.
+                When a key occurs more than once, the last value is kept.
+ */
+#define kh_build(name, h, n, keys, vals) kh_build_##name(h, n, keys, vals)
+
+/*! @function
+  @abstract     Insert all elements of a hash table into another.
+  @param  name  Name of the hash tables [symbol]
+  @param  dst   Pointer to the destination hash table [khash_t(name)*]
+  @param  src   Pointer to the source hash table; unchanged [khash_t(name)*]
+  @param  combine  Function computing the value of a key present in both
+                tables from the values in dst and src, e.g.
+                kh_combine_sum_int; NULL keeps the value in dst
+                [type of values (*)(type of values, type of values)]
+  @discussion   dst is grown once to hold both tables, and keys are inserted
+                in windows with kh_put_batch(). For keys owned by the tables
+                (e.g. strdup'ed strings), keys new to dst are shared with src.
+ */
+#define kh_merge(name, dst, src, combine) kh_merge_##name(dst, src, combine)
+
+/*! @function
+  @abstract     Define kh_combine_{sum,max,min}_suffix() value combiners for kh_merge()
+  @param  suffix   Suffix of the function names [symbol]
+  @param  khval_t  Type of values [type]
+ */
+#define KH_COMBINE_INIT(suffix, khval_t)								\
+	static inline khval_t kh_combine_sum_##suffix(khval_t a, khval_t b) { return a + b; } \
+	static inline khval_t kh_combine_max_##suffix(khval_t a, khval_t b) { return a > b? a : b; } \
+	static inline khval_t kh_combine_min_##suffix(khval_t a, khval_t b) { return a < b? a : b; }
+
+KH_COMBINE_INIT(int, int)
+KH_COMBINE_INIT(int64, khint64_t)
+KH_COMBINE_INIT(double, double)
+
+/*! @function
+  @abstract     Make room for n elements.
+  @param  name  Name of the hash table [symbol]
+  @param  h     Pointer to the hash table [khash_t(name)*]
+  @param  n     Number of elements [khint_t]
+  @discussion   kh_put() will not resize the table until it holds more than n
+                elements, provided no element is deleted in between.
+ */
+#define kh_reserve(name, h, n) kh_reserve_##name(h, n)
+
 /*! @function
   @abstract     Remove a key from the hash table.
   @param  name  Name of the hash table [symbol]
@@ -418,6 +2197,34 @@ static inline khint_t __ac_X31_hash_string(const char *s)
  */
 #define kh_del(name, h, k) kh_del_##name(h, k)
 
+/*! @function
+  @abstract     Insert a string key, copying it into the table's arena if absent.
+  @param  name  Name of the hash table [symbol]
+  @param  h     Pointer to the hash table [khash_t(name)*]
+  @param  k     Key; may be a reused buffer [const char*]
+  @param  r     Extra return code as kh_put() [int*]
+  @return       Iterator to the inserted element [khint_t]
+  @discussion   The copies are freed all at once by kh_destroy(); kh_del() and
+                kh_clear() do not release them. Available for tables
+                instantiated by KHASH_{SET,MAP}_INIT_STR, or by
+                KHASH_INTERN_INIT() for other tables with const char* keys.
+ */
+#define kh_put_str_intern(name, h, k, r) kh_put_str_intern_##name(h, k, r)
+
+/*! @function
+  @abstract     Insert a string to a table with kh_sso_key_t keys.
+  @param  name  Name of the hash table [symbol]
+  @param  h     Pointer to the hash table [khash_t(name)*]
+  @param  p     Pointer to the string; may be a reused buffer [const char*]
+  @param  len   Length of the string [khint32_t]
+  @param  r     Extra return code as kh_put() [int*]
+  @return       Iterator to the inserted element [khint_t]
+  @discussion   Short strings are copied into the bucket; a new long string is
+                copied, null terminated, into the table's arena. Look keys up
+                with kh_get(name, h, kh_sso(p, len)).
+ */
+#define kh_sso_put(name, h, p, len, r) kh_sso_put_##name(h, p, len, r)
+
 
 /*! @function
   @abstract     Test whether a bucket contains data.
@@ -427,6 +2234,30 @@ static inline khint_t __ac_X31_hash_string(const char *s)
  */
 #define kh_exist(h, x) (!__ac_iseither((h)->flags, (x)))
 
+/*! @function
+  @abstract     Test whether a bucket of a KHASH_INIT2_SWISS table contains data.
+  @param  h     Pointer to the hash table [khash_t(name)*]
+  @param  x     Iterator to the bucket [khint_t]
+  @return       1 if containing data; 0 otherwise [int]
+ */
+#define kh_exist_swiss(h, x) ((h)->ctrl[x] < __ac_CTRL_EMPTY)
+
+/*! @function
+  @abstract     Test whether a bucket of a KHASH_INIT2_RH table contains data.
+  @param  h     Pointer to the hash table [khash_t(name)*]
+  @param  x     Iterator to the bucket [khint_t]
+  @return       1 if containing data; 0 otherwise [int]
+ */
+#define kh_exist_rh(h, x) ((h)->dist[x] != 0)
+
+/*! @function
+  @abstract     Test whether a bucket of a KHASH_INIT2_AOS table contains data.
+  @param  h     Pointer to the hash table [khash_t(name)*]
+  @param  x     Iterator to the bucket [khint_t]
+  @return       1 if containing data; 0 otherwise [int]
+ */
+#define kh_exist_aos(h, x) ((h)->buckets[x].flag == __ac_AOS_FULL)
+
 /*! @function
   @abstract     Get key given an iterator
   @param  h     Pointer to the hash table [khash_t(name)*]
@@ -449,6 +2280,22 @@ static inline khint_t __ac_X31_hash_string(const char *s)
  */
 #define kh_value(h, x) ((h)->vals[x])
 
+/*! @function
+  @abstract     Get key given an iterator of a KHASH_INIT2_AOS table
+  @param  h     Pointer to the hash table [khash_t(name)*]
+  @param  x     Iterator to the bucket [khint_t]
+  @return       Key [type of keys]
+ */
+#define kh_key_aos(h, x) ((h)->buckets[x].key)
+
+/*! @function
+  @abstract     Get value given an iterator of a KHASH_INIT2_AOS table
+  @param  h     Pointer to the hash table [khash_t(name)*]
+  @param  x     Iterator to the bucket [khint_t]
+  @return       Value [type of values]
+ */
+#define kh_val_aos(h, x) ((h)->buckets[x].val)
+
 /*! @function
   @abstract     Get the start iterator
   @param  h     Pointer to the hash table [khash_t(name)*]
@@ -515,7 +2362,8 @@ typedef const char *kh_cstr_t;
   @param  name  Name of the hash table [symbol]
  */
 #define KHASH_SET_INIT_STR(name)										\
-	KHASH_INIT(name, kh_cstr_t, char, 0, kh_str_hash_func, kh_str_hash_equal)
+	KHASH_INIT(name, kh_cstr_t, char, 0, kh_str_hash_func, kh_str_hash_equal) \
+	KHASH_INTERN_INIT(name)
 
 /*! @function
   @abstract     Instantiate a hash map containing const char* keys
@@ -523,6 +2371,161 @@ typedef const char *kh_cstr_t;
   @param  khval_t  Type of values [type]
  */
 #define KHASH_MAP_INIT_STR(name, khval_t)								\
-	KHASH_INIT(name, kh_cstr_t, khval_t, 1, kh_str_hash_func, kh_str_hash_equal)
+	KHASH_INIT(name, kh_cstr_t, khval_t, 1, kh_str_hash_func, kh_str_hash_equal) \
+	KHASH_INTERN_INIT(name)
+
+/*! @function
+  @abstract     Instantiate a hash set containing kh_strh_key_t keys
+  @param  name  Name of the hash table [symbol]
+ */
+#define KHASH_SET_INIT_STRH(name)										\
+	KHASH_INIT(name, kh_strh_key_t, char, 0, kh_strh_hash_func, kh_strh_hash_equal)
+
+/*! @function
+  @abstract     Instantiate a hash map containing kh_strh_key_t keys
+  @param  name  Name of the hash table [symbol]
+  @param  khval_t  Type of values [type]
+  @discussion   Keys are built with kh_strh(), e.g.
+                k = kh_put(name, h, kh_strh(s), &ret). The string pointer is
+                stored as given; kh_key(h, k).s may be replaced by a copy.
+ */
+#define KHASH_MAP_INIT_STRH(name, khval_t)								\
+	KHASH_INIT(name, kh_strh_key_t, khval_t, 1, kh_strh_hash_func, kh_strh_hash_equal)
+
+/*! @function
+  @abstract     Instantiate a hash set containing kh_sv_key_t keys
+  @param  name  Name of the hash table [symbol]
+ */
+#define KHASH_SET_INIT_SV(name)											\
+	KHASH_INIT(name, kh_sv_key_t, char, 0, kh_sv_hash_func, kh_sv_hash_equal)
+
+/*! @function
+  @abstract     Instantiate a hash map containing kh_sv_key_t keys
+  @param  name  Name of the hash table [symbol]
+  @param  khval_t  Type of values [type]
+  @discussion   Keys may point into a larger buffer, e.g. an mmap'ed input
+                file; a key only needs to be copied when kh_put() reports
+                it as new, after which kh_key(h, k).p is set to the copy.
+ */
+#define KHASH_MAP_INIT_SV(name, khval_t)								\
+	KHASH_INIT(name, kh_sv_key_t, khval_t, 1, kh_sv_hash_func, kh_sv_hash_equal)
+
+/*! @function
+  @abstract     Instantiate a hash set containing kh_sso_key_t keys
+  @param  name  Name of the hash table [symbol]
+ */
+#define KHASH_SET_INIT_SSO(name)										\
+	KHASH_INIT(name, kh_sso_key_t, char, 0, kh_sso_hash_func, kh_sso_hash_equal) \
+	KHASH_SSO_INIT(name)
+
+/*! @function
+  @abstract     Instantiate a hash map containing kh_sso_key_t keys
+  @param  name  Name of the hash table [symbol]
+  @param  khval_t  Type of values [type]
+ */
+#define KHASH_MAP_INIT_SSO(name, khval_t)								\
+	KHASH_INIT(name, kh_sso_key_t, khval_t, 1, kh_sso_hash_func, kh_sso_hash_equal) \
+	KHASH_SSO_INIT(name)
+
+/*! @function
+  @abstract     Instantiate a group-probing hash map containing integer keys
+  @param  name  Name of the hash table [symbol]
+  @param  khval_t  Type of values [type]
+ */
+#define KHASH_MAP_INIT_INT_SWISS(name, khval_t)							\
+	KHASH_INIT_SWISS(name, khint32_t, khval_t, 1, kh_int_hash_func, kh_int_hash_equal)
+
+/*! @function
+  @abstract     Instantiate a group-probing hash map containing 64-bit integer keys
+  @param  name  Name of the hash table [symbol]
+  @param  khval_t  Type of values [type]
+ */
+#define KHASH_MAP_INIT_INT64_SWISS(name, khval_t)						\
+	KHASH_INIT_SWISS(name, khint64_t, khval_t, 1, kh_int64_hash_func, kh_int64_hash_equal)
+
+/*! @function
+  @abstract     Instantiate a group-probing hash map containing const char* keys
+  @param  name  Name of the hash table [symbol]
+  @param  khval_t  Type of values [type]
+ */
+#define KHASH_MAP_INIT_STR_SWISS(name, khval_t)							\
+	KHASH_INIT_SWISS(name, kh_cstr_t, khval_t, 1, kh_str_hash_func, kh_str_hash_equal)
+
+/*! @function
+  @abstract     Instantiate a Robin Hood hash map containing integer keys
+  @param  name  Name of the hash table [symbol]
+  @param  khval_t  Type of values [type]
+ */
+#define KHASH_MAP_INIT_INT_RH(name, khval_t)							\
+	KHASH_INIT_RH(name, khint32_t, khval_t, 1, kh_int_hash_func, kh_int_hash_equal)
+
+/*! @function
+  @abstract     Instantiate a Robin Hood hash map containing const char* keys
+  @param  name  Name of the hash table [symbol]
+  @param  khval_t  Type of values [type]
+ */
+#define KHASH_MAP_INIT_STR_RH(name, khval_t)							\
+	KHASH_INIT_RH(name, kh_cstr_t, khval_t, 1, kh_str_hash_func, kh_str_hash_equal)
+
+/*! @function
+  @abstract     Instantiate an interleaved hash map containing integer keys
+  @param  name  Name of the hash table [symbol]
+  @param  khval_t  Type of values [type]
+ */
+#define KHASH_MAP_INIT_INT_AOS(name, khval_t)							\
+	KHASH_INIT_AOS(name, khint32_t, khval_t, 1, kh_int_hash_func, kh_int_hash_equal)
+
+/*! @function
+  @abstract     Instantiate an interleaved hash map containing const char* keys
+  @param  name  Name of the hash table [symbol]
+  @param  khval_t  Type of values [type]
+ */
+#define KHASH_MAP_INIT_STR_AOS(name, khval_t)							\
+	KHASH_INIT_AOS(name, kh_cstr_t, khval_t, 1, kh_str_hash_func, kh_str_hash_equal)
+
+/*! @function
+  @abstract     Instantiate a 64-bit indexed hash set containing integer keys
+  @param  name  Name of the hash table [symbol]
+ */
+#define KHASH64_SET_INIT_INT(name)										\
+	KHASH_INIT_64(name, khint32_t, char, 0, kh_int_hash_func64, kh_int_hash_equal)
+
+/*! @function
+  @abstract     Instantiate a 64-bit indexed hash map containing integer keys
+  @param  name  Name of the hash table [symbol]
+  @param  khval_t  Type of values [type]
+ */
+#define KHASH64_MAP_INIT_INT(name, khval_t)								\
+	KHASH_INIT_64(name, khint32_t, khval_t, 1, kh_int_hash_func64, kh_int_hash_equal)
+
+/*! @function
+  @abstract     Instantiate a 64-bit indexed hash set containing 64-bit integer keys
+  @param  name  Name of the hash table [symbol]
+ */
+#define KHASH64_SET_INIT_INT64(name)									\
+	KHASH_INIT_64(name, khint64_t, char, 0, kh_int64_hash_func64, kh_int64_hash_equal)
+
+/*! @function
+  @abstract     Instantiate a 64-bit indexed hash map containing 64-bit integer keys
+  @param  name  Name of the hash table [symbol]
+  @param  khval_t  Type of values [type]
+ */
+#define KHASH64_MAP_INIT_INT64(name, khval_t)							\
+	KHASH_INIT_64(name, khint64_t, khval_t, 1, kh_int64_hash_func64, kh_int64_hash_equal)
+
+/*! @function
+  @abstract     Instantiate a 64-bit indexed hash set containing const char* keys
+  @param  name  Name of the hash table [symbol]
+ */
+#define KHASH64_SET_INIT_STR(name)										\
+	KHASH_INIT_64(name, kh_cstr_t, char, 0, kh_str_hash_func64, kh_str_hash_equal)
+
+/*! @function
+  @abstract     Instantiate a 64-bit indexed hash map containing const char* keys
+  @param  name  Name of the hash table [symbol]
+  @param  khval_t  Type of values [type]
+ */
+#define KHASH64_MAP_INIT_STR(name, khval_t)								\
+	KHASH_INIT_64(name, kh_cstr_t, khval_t, 1, kh_str_hash_func64, kh_str_hash_equal)
 
 #endif /* __AC_KHASH_H */
@@ -0,0 +1,296 @@
+/* The MIT License
+
+   Copyright (c) 2026 by the khash contributors
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+/*
+  An example:
+
+#include "khash.hpp"
+int main() {
+	int ret;
+	khint_t k;
+	kh::map<std::string, int> h; // kh::pow2 buckets by default
+	k = h.put("abc", &ret);      // a std::string is only built if "abc" is new
+	h.value(k) = 10;
+	++h[std::string_view("abc")];
+	k = h.get("abc");
+	if (k != h.end()) h.del(k);
+	for (k = h.begin(); k != h.end(); ++k)
+		if (h.exist(k)) h.value(k) = 1;
+	return 0;
+}
+*/
+
+#ifndef __AC_KHASH_HPP
+#define __AC_KHASH_HPP
+
+/*!
+  @header
+
+  C++17 front-end to khash. kh::map<K, V, Hash, Eq, Policy> is a template
+  over the algorithms of KHASH_INIT2: the same 2-bit flags, the same
+  bucket-count policies (kh::prime, kh::pow2) and probing, and the same
+  iterator-as-bucket-index interface. Unlike the C tables, keys and values
+  are constructed in place, moved on resize and destroyed on deletion, so
+  any movable type can be stored.
+
+  Lookup and insertion are templates on the key argument: with the default
+  kh::hash and equality, a std::string map can be queried with a
+  std::string_view or a const char* without building a temporary string,
+  and put() only constructs the key when it is absent.
+
+  @copyright the khash contributors
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "khash.h"
+
+namespace kh {
+
+/* Hash functions, returning the same values as their C counterparts. All
+   but the string_view hash are constexpr; that one is wyhash, whose word
+   loads go through memcpy() and so can only run at run time */
+template<class T, class = void> struct hash;
+
+template<class T> struct hash<T, std::enable_if_t<std::is_integral_v<T>>> {
+	constexpr khint_t operator()(T key) const {
+		if constexpr (sizeof(T) <= sizeof(khint32_t)) return kh_int_hash_func((khint32_t)key);
+		else return kh_int64_hash_func((khint64_t)key);
+	}
+};
+
+struct __str_hash {
+	using is_transparent = void;
+	khint_t operator()(std::string_view s) const { return kh_strn_hash_func(s.data(), s.size()); }
+};
+template<> struct hash<std::string> : __str_hash {};
+template<> struct hash<std::string_view> : __str_hash {};
+
+template<> struct hash<const char*> { // __ac_X31_hash_string()
+	constexpr khint_t operator()(const char *s) const {
+		khint_t h = *s;
+		if (h) for (++s ; *s; ++s) h = (h << 5) - h + *s;
+		return h;
+	}
+};
+
+/* Equality; transparent, and comparing characters for const char* keys */
+template<class T> struct equal_to : std::equal_to<> {};
+
+template<> struct equal_to<const char*> {
+	constexpr bool operator()(const char *a, const char *b) const { return std::string_view(a) == std::string_view(b); }
+};
+
+/* Bucket-count policies; see the __ac_<policy>_* macros in khash.h */
+struct prime {
+	static khint_t size(khint_t n) { return __ac_prime_size(n); }
+	static constexpr khint_t hash(khint_t k) { return __ac_prime_hash(k); }
+	static constexpr khint_t first(khint_t k, khint_t n) { return __ac_prime_first(k, n); }
+	static constexpr khint_t inc(khint_t k, khint_t n) { return __ac_prime_inc(k, n); }
+	static constexpr void next(khint_t n, khint_t &i, khint_t &inc) { __ac_prime_next(n, i, inc); }
+	static constexpr bool done(khint_t n, khint_t i, khint_t last, khint_t inc) { return (void)n, (void)inc, __ac_prime_done(n, i, last, inc); }
+};
+
+struct pow2 {
+	static khint_t size(khint_t n) { return __ac_pow2_size(n); }
+	static khint_t hash(khint_t k) { return __ac_pow2_hash(k); }
+	static constexpr khint_t first(khint_t k, khint_t n) { return __ac_pow2_first(k, n); }
+	static constexpr khint_t inc(khint_t k, khint_t n) { return (void)k, (void)n, __ac_pow2_inc(k, n); }
+	static constexpr void next(khint_t n, khint_t &i, khint_t &inc) { __ac_pow2_next(n, i, inc); }
+	static constexpr bool done(khint_t n, khint_t i, khint_t last, khint_t inc) { return (void)i, __ac_pow2_done(n, i, last, inc); }
+};
+
+template<class K, class V, class Hash = hash<K>, class Eq = equal_to<K>, class Policy = pow2>
+class map {
+	khint_t n_buckets_ = 0, size_ = 0, n_occupied_ = 0, upper_bound_ = 0;
+	khint32_t *flags_ = nullptr;
+	K *keys_ = nullptr;
+	V *vals_ = nullptr;
+	Hash hash_;
+	Eq eq_;
+
+	static khint32_t *new_flags(khint_t n) {
+		khint32_t *f = (khint32_t*)std::malloc(((n>>4) + 1) * sizeof(khint32_t));
+		if (f == nullptr) throw std::bad_alloc();
+		std::memset(f, 0xaa, ((n>>4) + 1) * sizeof(khint32_t));
+		return f;
+	}
+	template<class T> static T *new_array(khint_t n) {
+		T *p = (T*)std::malloc(n * sizeof(T));
+		if (p == nullptr && n) throw std::bad_alloc();
+		return p;
+	}
+	struct free_deleter { void operator()(void *p) const noexcept { std::free(p); } };
+	template<class T> using buffer = std::unique_ptr<T[], free_deleter>; // owns an array until it is installed
+	void destroy_all() {
+		if (!std::is_trivially_destructible_v<K> || !std::is_trivially_destructible_v<V>)
+			for (khint_t i = 0; i != n_buckets_; ++i)
+				if (exist(i)) keys_[i].~K(), vals_[i].~V();
+	}
+
+public:
+	map() = default;
+	explicit map(const Hash &h, const Eq &e = Eq()) : hash_(h), eq_(e) {}
+	map(const map&) = delete;
+	map &operator=(const map&) = delete;
+	map(map &&o) noexcept { swap(o); }
+	map &operator=(map &&o) noexcept { map t(std::move(o)); swap(t); return *this; }
+	~map() {
+		destroy_all();
+		std::free(flags_); std::free(keys_); std::free(vals_);
+	}
+	void swap(map &o) noexcept {
+		std::swap(n_buckets_, o.n_buckets_); std::swap(size_, o.size_);
+		std::swap(n_occupied_, o.n_occupied_); std::swap(upper_bound_, o.upper_bound_);
+		std::swap(flags_, o.flags_); std::swap(keys_, o.keys_); std::swap(vals_, o.vals_);
+		std::swap(hash_, o.hash_); std::swap(eq_, o.eq_);
+	}
+
+	khint_t size() const { return size_; }
+	khint_t n_buckets() const { return n_buckets_; }
+	khint_t begin() const { return 0; }
+	khint_t end() const { return n_buckets_; }
+	bool exist(khint_t x) const { return !__ac_iseither(flags_, x); }
+	const K &key(khint_t x) const { return keys_[x]; }
+	V &value(khint_t x) { return vals_[x]; }
+	const V &value(khint_t x) const { return vals_[x]; }
+
+	void clear() {
+		if (flags_) {
+			destroy_all();
+			std::memset(flags_, 0xaa, ((n_buckets_>>4) + 1) * sizeof(khint32_t));
+			size_ = n_occupied_ = 0;
+		}
+	}
+
+	/* Rebuild with at least new_n_buckets buckets; does nothing if they could not hold size() keys */
+	void resize(khint_t new_n_buckets) {
+		new_n_buckets = Policy::size(new_n_buckets);
+		if (size_ >= (khint_t)(new_n_buckets * __ac_HASH_UPPER + 0.5)) return;
+		buffer<khint32_t> f(new_flags(new_n_buckets)); // not leaked if a later allocation throws
+		buffer<K> ks(new_array<K>(new_n_buckets));
+		buffer<V> vs(new_array<V>(new_n_buckets));
+		khint32_t *flags = f.get();
+		K *keys = ks.get();
+		V *vals = vs.get();
+		for (khint_t j = 0; j != n_buckets_; ++j) {
+			if (!exist(j)) continue;
+			khint_t k = Policy::hash(hash_(keys_[j]));
+			khint_t i = Policy::first(k, new_n_buckets), inc = Policy::inc(k, new_n_buckets);
+			while (!__ac_isempty(flags, i)) Policy::next(new_n_buckets, i, inc);
+			__ac_set_isboth_false(flags, i);
+			new (&keys[i]) K(std::move(keys_[j])); keys_[j].~K();
+			new (&vals[i]) V(std::move(vals_[j])); vals_[j].~V();
+		}
+		std::free(flags_); std::free(keys_); std::free(vals_);
+		flags_ = f.release(), keys_ = ks.release(), vals_ = vs.release();
+		n_buckets_ = new_n_buckets;
+		n_occupied_ = size_;
+		upper_bound_ = (khint_t)(n_buckets_ * __ac_HASH_UPPER + 0.5);
+	}
+
+	/* Make room for n elements, as kh_reserve() */
+	void reserve(khint_t n) {
+		if (n > size_ && n_occupied_ + (n - size_) > upper_bound_) {
+			khint_t t = (khint_t)(n / __ac_HASH_UPPER) + 1;
+			resize(t > n_buckets_? t : n_buckets_ - 1);
+		}
+	}
+
+	/* Iterator to a key, or end() if absent */
+	template<class Q> khint_t get(const Q &key) const {
+		if (n_buckets_ == 0) return 0;
+		khint_t k = Policy::hash(hash_(key));
+		khint_t i = Policy::first(k, n_buckets_), inc = Policy::inc(k, n_buckets_), last = i;
+		while (!__ac_isempty(flags_, i) && (__ac_isdel(flags_, i) || !eq_(keys_[i], key))) {
+			Policy::next(n_buckets_, i, inc);
+			if (Policy::done(n_buckets_, i, last, inc)) return n_buckets_;
+		}
+		return __ac_iseither(flags_, i)? n_buckets_ : i;
+	}
+
+	/* Insert a key, as kh_put(); a new key is constructed from the argument
+	   (moved if an rvalue) and its value is value-initialized */
+	template<class Q> khint_t put(Q &&key, int *ret = nullptr) {
+		if (n_occupied_ >= upper_bound_) {
+			if (n_buckets_ > (size_<<1)) resize(n_buckets_ - 1); // clear "deleted" elements
+			else resize(n_buckets_ + 1); // expand the hash table
+		}
+		khint_t k = Policy::hash(hash_(key)), x = n_buckets_, site = n_buckets_;
+		khint_t i = Policy::first(k, n_buckets_);
+		if (__ac_isempty(flags_, i)) x = i;
+		else {
+			khint_t inc = Policy::inc(k, n_buckets_), last = i;
+			while (!__ac_isempty(flags_, i) && (__ac_isdel(flags_, i) || !eq_(keys_[i], key))) {
+				if (__ac_isdel(flags_, i)) site = i;
+				Policy::next(n_buckets_, i, inc);
+				if (Policy::done(n_buckets_, i, last, inc)) { x = site; break; }
+			}
+			if (x == n_buckets_) x = __ac_isempty(flags_, i) && site != n_buckets_? site : i;
+		}
+		int r = 0;
+		if (__ac_iseither(flags_, x)) {
+			new (&keys_[x]) K(std::forward<Q>(key));
+			try {
+				new (&vals_[x]) V();
+			} catch (...) { // the bucket stays empty or deleted
+				keys_[x].~K();
+				throw;
+			}
+			r = __ac_isempty(flags_, x)? 1 : 2;
+			if (r == 1) ++n_occupied_;
+			__ac_set_isboth_false(flags_, x);
+			++size_;
+		}
+		if (ret) *ret = r;
+		return x;
+	}
+
+	/* Value of a key, inserted if absent */
+	template<class Q> V &operator[](Q &&key) {
+		khint_t x = put(std::forward<Q>(key)); // may reallocate vals_
+		return vals_[x];
+	}
+
+	/* Remove the element at an iterator, as kh_del() */
+	void del(khint_t x) {
+		if (x != n_buckets_ && exist(x)) {
+			keys_[x].~K(); vals_[x].~V();
+			__ac_set_isdel_true(flags_, x);
+			--size_;
+		}
+	}
+};
+
+} // namespace kh
+
+#endif /* __AC_KHASH_HPP */
@@ -0,0 +1,317 @@
+/* The MIT License
+
+   Copyright (c) 2026 by the khash contributors
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+/*
+  An example:
+
+#include "khash_filter.h"
+KHASH_MAP_INIT_INT64(64, int)
+KHASH_FILTER_INIT(64, khint64_t, kh_int64_hash_func, prime) // KHASH_MAP_INIT_INT64 tables use the prime policy
+int main() {
+	int ret;
+	khint_t k;
+	khf_t(64) *t = khf_init(64);
+	k = khf_put(64, t, 5, &ret);        // kh_put() on the table, and adds 5 to the filter
+	kh_val(khf_table(t), k) = 10;
+	k = khf_get(64, t, 6);              // usually answered by the filter alone
+	k = khf_get(64, t, 5);
+	khf_del(64, t, k);                  // removes 5 from both
+	khf_destroy(64, t);
+	return 0;
+}
+*/
+
+#ifndef __AC_KHASH_FILTER_H
+#define __AC_KHASH_FILTER_H
+
+/*!
+  @header
+
+  Membership filter in front of a hash table, so that lookups of absent
+  keys rarely touch the table. kcf_t is a cuckoo-style filter made of
+  64-byte blocks, each holding 31 16-bit words and a count of the
+  fingerprints that overflowed into an alternate block. A key hashes to one
+  block, so a negative lookup usually reads one cache line; the alternate
+  block is only read when the primary one has overflowed. A word is a
+  15-bit fingerprint and a bit telling whether it was stored in its
+  alternate block, so a key only ever matches, and kcf_del() only removes,
+  a copy stored for its own primary block; this keeps the filter exact
+  under deletion. The false positive rate is about (fingerprints per
+  block)/2^15, under 0.1% at the default load.
+
+  KHASH_FILTER_INIT() wraps a KHASH_INIT2 or KHASH_INIT2_POW2 table, and
+  KHASH_FILTER_INIT_64() a KHASH_INIT2_64 one, and keeps the filter in
+  sync on khf_put() and khf_del(); the filter is rebuilt from the table
+  when it fills up. The wrappers hash a key once and hand the hash to
+  kh_get_hashed()/kh_put_hashed(), which only these tables have, so the
+  SWISS, INCR, LP, RH and AOS tables and kh::map cannot be wrapped; kcf_t
+  can still be used directly in front of them, with any 64-bit hash.
+
+  @copyright the khash contributors
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "khash.h"
+
+typedef unsigned short khint16_t;
+
+#define __ac_CF_SLOTS 31 /* fingerprints per block; word 31 counts overflows */
+#define __ac_CF_LOAD 20  /* fingerprints per block when sized by kcf_init() */
+
+typedef struct {
+	khint64_t mask;  /* number of blocks - 1 */
+	khint64_t size;  /* number of fingerprints */
+	khint16_t *w;    /* 32 words per block */
+} kcf_t;
+
+/*! @function
+  @abstract     Initiate a filter sized for n keys.
+ */
+static inline kcf_t *kcf_init(khint64_t n)
+{
+	kcf_t *f;
+	khint64_t m = 2;
+	void *p;
+	while (m * __ac_CF_LOAD < n) m <<= 1;
+	if (posix_memalign(&p, 64, m * 64) != 0) return 0;
+	memset(p, 0, m * 64);
+	f = (kcf_t*)calloc(1, sizeof(kcf_t));
+	f->mask = m - 1, f->w = (khint16_t*)p;
+	return f;
+}
+
+static inline void kcf_destroy(kcf_t *f)
+{
+	if (f) free(f->w), free(f);
+}
+
+static inline khint16_t __ac_cf_fp(khint64_t x)
+{ /* fingerprint with the "in the alternate block" bit cleared; 0 marks an empty slot */
+	khint16_t fp = (khint16_t)(x & 0x7fff);
+	return (khint16_t)((fp? fp : 1) << 1);
+}
+
+static inline khint16_t *__ac_cf_block(const kcf_t *f, khint64_t x)
+{
+	return f->w + ((x >> 32 & f->mask) << 5);
+}
+
+static inline khint16_t *__ac_cf_alt(const kcf_t *f, const khint16_t *b, khint16_t fp)
+{
+	khint64_t i = (khint64_t)(b - f->w) >> 5, j = (i ^ ((khint32_t)fp * 0x9e3779b1U >> 8)) & f->mask;
+	return f->w + ((j == i? i ^ 1 : j) << 5);
+}
+
+/* bit i of the result is set if slot i of the block holds v */
+static inline khint32_t __ac_cf_match(const khint16_t *b, khint16_t v)
+{
+#ifdef __AC_SWISS_SSE2
+	const __m128i *p = (const __m128i*)b;
+	__m128i q = _mm_set1_epi16((short)v);
+	khint32_t lo = (khint32_t)_mm_movemask_epi8(_mm_packs_epi16(_mm_cmpeq_epi16(p[0], q), _mm_cmpeq_epi16(p[1], q)));
+	khint32_t hi = (khint32_t)_mm_movemask_epi8(_mm_packs_epi16(_mm_cmpeq_epi16(p[2], q), _mm_cmpeq_epi16(p[3], q)));
+	return (lo | hi << 16) & 0x7fffffffU;
+#else
+	khint32_t i, m = 0;
+	for (i = 0; i < __ac_CF_SLOTS; ++i)
+		m |= (khint32_t)(b[i] == v) << i;
+	return m;
+#endif
+}
+
+/*! @function
+  @abstract     Test a hash; 0 means it has definitely not been added.
+ */
+static inline int kcf_test(const kcf_t *f, khint64_t x)
+{
+	const khint16_t *b = __ac_cf_block(f, x);
+	khint16_t fp = __ac_cf_fp(x);
+	if (__ac_cf_match(b, fp)) return 1;
+	return b[__ac_CF_SLOTS] && __ac_cf_match(__ac_cf_alt(f, b, fp), fp | 1);
+}
+
+/*! @function
+  @abstract     Add a hash; it may be added more than once.
+  @return       1 on success; 0 if both of its blocks are full [int]
+ */
+static inline int kcf_add(kcf_t *f, khint64_t x)
+{
+	khint16_t *b = __ac_cf_block(f, x), *a;
+	khint16_t fp = __ac_cf_fp(x);
+	khint32_t m = __ac_cf_match(b, 0);
+	if (m) {
+		b[__ac_ctz32(m)] = fp, ++f->size;
+		return 1;
+	}
+	if (b[__ac_CF_SLOTS] == 0xffff) return 0;
+	a = __ac_cf_alt(f, b, fp);
+	if ((m = __ac_cf_match(a, 0)) == 0) return 0;
+	a[__ac_ctz32(m)] = fp | 1, ++b[__ac_CF_SLOTS], ++f->size;
+	return 1;
+}
+
+/*! @function
+  @abstract     Remove one copy of a hash, which must have been added.
+ */
+static inline void kcf_del(kcf_t *f, khint64_t x)
+{
+	khint16_t *b = __ac_cf_block(f, x), *a;
+	khint16_t fp = __ac_cf_fp(x);
+	khint32_t m = __ac_cf_match(b, fp);
+	if (m) {
+		b[__ac_ctz32(m)] = 0, --f->size;
+		return;
+	}
+	if (b[__ac_CF_SLOTS] == 0) return;
+	a = __ac_cf_alt(f, b, fp);
+	if ((m = __ac_cf_match(a, fp | 1)) != 0)
+		a[__ac_ctz32(m)] = 0, --b[__ac_CF_SLOTS], --f->size;
+}
+
+/* the filter hash is derived from the table's own hash, so a key is hashed once */
+#define __ac_cf_hash(k) __ac_fmix64((khint64_t)(k))
+
+#define __KHASH_FILTER_IMPL(name, khkey_t, __hash_func, __policy, khidx_t) \
+	typedef struct {													\
+		kh_##name##_t *h;												\
+		kcf_t *f;														\
+	} khf_##name##_t;													\
+	static inline khf_##name##_t *khf_init_##name(void)					\
+	{																	\
+		khf_##name##_t *t = (khf_##name##_t*)calloc(1, sizeof(khf_##name##_t)); \
+		t->h = kh_init(name);											\
+		t->f = kcf_init(0);												\
+		return t;														\
+	}																	\
+	static inline void khf_destroy_##name(khf_##name##_t *t)			\
+	{																	\
+		if (t) {														\
+			kh_destroy(name, t->h);										\
+			kcf_destroy(t->f);											\
+			free(t);													\
+		}																\
+	}																	\
+	static inline void khf_rebuild_##name(khf_##name##_t *t, khint64_t n) \
+	{																	\
+		khidx_t k;														\
+		for (;;) {														\
+			kcf_t *f = kcf_init(n);										\
+			for (k = 0; k != kh_end(t->h); ++k)							\
+				if (kh_exist(t->h, k) && !kcf_add(f, __ac_cf_hash(__ac_##__policy##_hash(__hash_func(kh_key(t->h, k)))))) break; \
+			if (k == kh_end(t->h)) {									\
+				kcf_destroy(t->f);										\
+				t->f = f;												\
+				return;													\
+			}															\
+			kcf_destroy(f);												\
+			n <<= 1; /* an unlucky block; retry with more blocks */		\
+		}																\
+	}																	\
+	static inline khidx_t khf_get_##name(const khf_##name##_t *t, khkey_t key) \
+	{																	\
+		khidx_t k = __ac_##__policy##_hash(__hash_func(key));			\
+		if (!kcf_test(t->f, __ac_cf_hash(k))) return kh_end(t->h);		\
+		return kh_get_hashed_##name(t->h, key, k);						\
+	}																	\
+	static inline khidx_t khf_put_##name(khf_##name##_t *t, khkey_t key, int *ret) \
+	{																	\
+		khidx_t x = __ac_##__policy##_hash(__hash_func(key));			\
+		khidx_t k = kh_put_hashed_##name(t->h, key, x, ret);			\
+		if (*ret) {														\
+			if (kh_size(t->h) > (t->f->mask + 1) * __ac_CF_LOAD * 5 / 4 || !kcf_add(t->f, __ac_cf_hash(x))) \
+				khf_rebuild_##name(t, (khint64_t)kh_size(t->h) * 2);	\
+		}																\
+		return k;														\
+	}																	\
+	static inline void khf_del_##name(khf_##name##_t *t, khidx_t k)		\
+	{																	\
+		if (k != kh_end(t->h) && kh_exist(t->h, k)) {					\
+			kcf_del(t->f, __ac_cf_hash(__ac_##__policy##_hash(__hash_func(kh_key(t->h, k))))); \
+			kh_del(name, t->h, k);										\
+		}																\
+	}
+
+/*! @function
+  @abstract     Instantiate a filter in front of a KHASH_INIT2 or KHASH_INIT2_POW2 table
+  @param  name  Name of the hash table [symbol]
+  @param  khkey_t      Type of keys [type]
+  @param  __hash_func  Hash function of the table
+  @param  __policy     Bucket policy of the table: prime for KHASH_INIT2,
+                       pow2 for KHASH_INIT2_POW2 [symbol]
+ */
+#define KHASH_FILTER_INIT(name, khkey_t, __hash_func, __policy)			\
+	__KHASH_FILTER_IMPL(name, khkey_t, __hash_func, __policy, khint_t)
+
+/*! @function
+  @abstract     Instantiate a filter in front of a KHASH_INIT2_64 table
+  @param  name  Name of the hash table [symbol]
+  @param  khkey_t      Type of keys [type]
+  @param  __hash_func  64-bit hash function of the table
+ */
+#define KHASH_FILTER_INIT_64(name, khkey_t, __hash_func)				\
+	__KHASH_FILTER_IMPL(name, khkey_t, __hash_func, pow2_64, khint64_t)
+
+/*! @function
+  @abstract     Type of a filtered hash table.
+ */
+#define khf_t(name) khf_##name##_t
+
+/*! @function
+  @abstract     Initiate a filtered hash table.
+  @param  name  Name of a hash table instantiated with KHASH_FILTER_INIT() [symbol]
+  @return       Pointer to the filtered table [khf_t(name)*]
+ */
+#define khf_init(name) khf_init_##name()
+
+/*! @function
+  @abstract     Destroy a filtered hash table and its filter.
+ */
+#define khf_destroy(name, t) khf_destroy_##name(t)
+
+/*! @function
+  @abstract     Retrieve a key; as kh_get() but absent keys are mostly rejected by the filter.
+  @return       Iterator to the found element, or kh_end(khf_table(t)) if absent
+                [khint_t; khint64_t with KHASH_FILTER_INIT_64]
+ */
+#define khf_get(name, t, key) khf_get_##name(t, key)
+
+/*! @function
+  @abstract     Insert a key; as kh_put(), and adds a new key to the filter.
+ */
+#define khf_put(name, t, key, r) khf_put_##name(t, key, r)
+
+/*! @function
+  @abstract     Remove the element at an iterator from the table and the filter.
+ */
+#define khf_del(name, t, k) khf_del_##name(t, k)
+
+/*! @function
+  @abstract     The underlying table, for kh_val(), kh_exist() and iteration [khash_t(name)*]
+  @discussion   Keys must not be inserted or deleted through it directly.
+ */
+#define khf_table(t) ((t)->h)
+
+#endif /* __AC_KHASH_FILTER_H */
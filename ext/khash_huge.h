@@ -0,0 +1,144 @@
+/* The MIT License
+
+   Copyright (c) 2026 by the khash contributors
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+/*
+  An example:
+
+#include "khash_huge.h"
+KHASH_MAP_INIT_INT64(64, int)
+int main() {
+	int ret;
+	khash_t(64) *h = kh_init(64);
+	kh_set_allocator(h, &kh_huge_allocator); // before the first insertion
+	kh_put(64, h, 5, &ret);
+	kh_destroy(64, h);
+	return 0;
+}
+*/
+
+#ifndef __AC_KHASH_HUGE_H
+#define __AC_KHASH_HUGE_H
+
+/*!
+  @header
+
+  Bucket arrays on huge pages. Random probes into a table of several
+  gigabytes miss the TLB on nearly every access with 4 KB pages; with 2 MB
+  pages the whole table is covered by far fewer entries. kh_huge_allocator
+  first asks for pages from the hugetlbfs pool (MAP_HUGETLB), which is
+  usually empty unless vm.nr_hugepages is set; failing that it maps a 2 MB
+  aligned region and marks it MADV_HUGEPAGE so that transparent huge pages
+  back it even when THP is in "madvise" mode. Arrays smaller than a huge
+  page come from malloc().
+
+  Anonymous mappings are not part of POSIX, and <sys/mman.h> hides
+  MAP_ANONYMOUS under e.g. strict -std=c99. Compile with _DEFAULT_SOURCE
+  (or _GNU_SOURCE, _BSD_SOURCE) defined before any system header to get
+  huge pages; without it every array comes from malloc().
+
+  @copyright the khash contributors
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "khash.h"
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#define __ac_HUGE_PAGE ((size_t)2 << 20)
+
+static inline size_t __ac_huge_round(size_t size)
+{
+	return (size + __ac_HUGE_PAGE - 1) & ~(__ac_HUGE_PAGE - 1);
+}
+
+#ifdef MAP_ANONYMOUS
+static inline void *kh_huge_alloc(void *ctx, size_t size)
+{
+	size_t len = __ac_huge_round(size);
+	char *p, *q;
+	(void)ctx;
+	if (size < __ac_HUGE_PAGE) return malloc(size);
+#ifdef MAP_HUGETLB
+	p = (char*)mmap(0, len, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+	if (p != MAP_FAILED) return p;
+#endif
+	/* over-map by a huge page and trim both ends to get an aligned region */
+	p = (char*)mmap(0, len + __ac_HUGE_PAGE, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED) return 0;
+	q = (char*)(((size_t)p + __ac_HUGE_PAGE - 1) & ~(__ac_HUGE_PAGE - 1));
+	if (q > p) munmap(p, q - p);
+	munmap(q + len, p + __ac_HUGE_PAGE - q);
+#ifdef MADV_HUGEPAGE
+	madvise(q, len, MADV_HUGEPAGE);
+#endif
+	return q;
+}
+
+static inline void kh_huge_free(void *ctx, void *p, size_t size)
+{
+	(void)ctx;
+	if (size < __ac_HUGE_PAGE) free(p);
+	else munmap(p, __ac_huge_round(size));
+}
+
+static inline void *kh_huge_realloc(void *ctx, void *p, size_t old_size, size_t size)
+{
+	void *q;
+	if (old_size < __ac_HUGE_PAGE && size < __ac_HUGE_PAGE) return realloc(p, size);
+	if (old_size >= __ac_HUGE_PAGE && size >= __ac_HUGE_PAGE && __ac_huge_round(old_size) == __ac_huge_round(size)) return p;
+	if ((q = kh_huge_alloc(ctx, size)) != 0 && p) {
+		memcpy(q, p, old_size < size? old_size : size);
+		kh_huge_free(ctx, p, old_size);
+	}
+	return q;
+}
+#else /* no anonymous mappings; see the header doc */
+static inline void *kh_huge_alloc(void *ctx, size_t size)
+{
+	(void)ctx;
+	return malloc(size);
+}
+
+static inline void kh_huge_free(void *ctx, void *p, size_t size)
+{
+	(void)ctx, (void)size;
+	free(p);
+}
+
+static inline void *kh_huge_realloc(void *ctx, void *p, size_t old_size, size_t size)
+{
+	(void)ctx, (void)old_size;
+	return realloc(p, size);
+}
+#endif
+
+/*! @abstract Allocator backing bucket arrays with huge pages; see kh_set_allocator() */
+static const kh_allocator_t kh_huge_allocator = { 0, kh_huge_alloc, kh_huge_realloc, kh_huge_free };
+
+#endif /* __AC_KHASH_HUGE_H */
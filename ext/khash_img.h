@@ -0,0 +1,334 @@
+/* The MIT License
+
+   Copyright (c) 2026 by the khash contributors
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+/*
+  An example:
+
+#include "khash_img.h"
+KHASH_MAP_INIT_INT64(64, int)
+KHASH_IMG_INIT(64, khint64_t, int, prime)
+int main() {
+	int ret;
+	khint_t k;
+	khash_t(64) *h = kh_init(64), *m;
+	k = kh_put(64, h, 5, &ret);
+	kh_val(h, k) = 10;
+	kh_save(64, h, "t.khi");
+	kh_destroy(64, h);
+	m = kh_load(64, "t.khi"); // mmap'ed; nothing is read yet
+	k = kh_get(64, m, 5);     // faults in one page of flags, keys and values
+	printf("%d\n", kh_val(m, k));
+	kh_unload(64, m);
+	return 0;
+}
+*/
+
+#ifndef __AC_KHASH_IMG_H
+#define __AC_KHASH_IMG_H
+
+/*!
+  @header
+
+  On-disk images of KHASH_INIT2/KHASH_INIT2_POW2/KHASH_INIT2_64 tables.
+
+  An image is a header followed by the flags, keys and values arrays as
+  they are in memory, each starting at a 64-byte aligned offset. kh_load()
+  maps the file read-only and points a table header at these arrays, so the
+  table can be queried with kh_get() right away: pages are read on first
+  access and shared by all processes mapping the same file. A loaded table
+  must not be modified and is released with kh_unload().
+
+  For string keys (KHASH_IMG_INIT_STR), the image stores each key as an
+  offset into a string pool appended to the file. Such an image is not
+  queried in place: kh_load() maps the file privately (PROT_WRITE,
+  MAP_PRIVATE) and turns every offset back into a pointer. Loading is thus
+  O(n_buckets), and the keys array is copied on write into n_buckets
+  pointers of private memory; flags, values and strings stay shared and
+  lazily read. This is deliberate: kh_get() compares keys with the
+  table's own equality macro, which only receives the two keys and so has
+  no way to resolve an offset against the image base. Fixed-size keys
+  have no such pass, and storing a 64-bit hash of each string as the key
+  gives a string lookup that is read-only and O(1) to load.
+
+  An image is only valid for the same instantiation (key and value types,
+  bucket policy) and byte order as the table that was saved; the header
+  records the type sizes and the bucket policy, which KHASH_IMG_INIT takes
+  as an argument, so that gross mismatches are rejected. kh_load()
+  also rejects an image whose arrays are not where n_buckets puts them or
+  do not fit in the file, and, for string keys, one with a key offset
+  outside the pool, so that kh_get() on a loaded table stays inside the
+  mapping. The contents of the flags, keys and values are not checked.
+
+  @copyright the khash contributors
+ */
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "khash.h"
+
+#define __ac_IMG_MAGIC "KHIMG\1\0\0"
+#define __ac_IMG_ALIGN 64
+
+/* policy tags; a table probes with the policy it was instantiated with */
+#define __ac_IMG_POLICY_prime 1
+#define __ac_IMG_POLICY_pow2 2
+#define __ac_IMG_POLICY_pow2_64 3
+
+typedef struct {
+	char magic[8];
+	khint32_t idx_size, key_size, val_size, is_map, is_str, policy;
+	khint64_t n_buckets, size, upper_bound;
+	khint64_t off_flags, off_keys, off_vals, off_pool, len;
+} kh_img_hdr_t;
+
+typedef struct {
+	void *base;
+	size_t len;
+} kh_img_t;
+
+static inline khint64_t __ac_img_align(khint64_t x)
+{
+	return (x + __ac_IMG_ALIGN - 1) / __ac_IMG_ALIGN * __ac_IMG_ALIGN;
+}
+
+/* fill the offsets of a header; n_buckets and the sizes must be set */
+static inline void __ac_img_layout(kh_img_hdr_t *hdr, khint64_t pool_len)
+{
+	memcpy(hdr->magic, __ac_IMG_MAGIC, 8);
+	hdr->off_flags = __ac_img_align(sizeof(kh_img_hdr_t));
+	hdr->off_keys = __ac_img_align(hdr->off_flags + ((hdr->n_buckets>>4) + 1) * sizeof(khint32_t));
+	hdr->off_vals = __ac_img_align(hdr->off_keys + hdr->n_buckets * hdr->key_size);
+	hdr->off_pool = __ac_img_align(hdr->off_vals + (hdr->is_map? hdr->n_buckets * hdr->val_size : 0));
+	hdr->len = hdr->off_pool + pool_len;
+}
+
+static inline int __ac_img_write_at(FILE *fp, khint64_t off, const void *p, size_t len)
+{
+	static const char zero[__ac_IMG_ALIGN] = {0};
+	long cur = ftell(fp);
+	if (cur < 0 || (khint64_t)cur > off) return -1;
+	while ((khint64_t)cur < off) { /* pad in pieces no longer than zero[] */
+		size_t l = off - cur < sizeof(zero)? (size_t)(off - cur) : sizeof(zero);
+		if (fwrite(zero, 1, l, fp) != l) return -1;
+		cur += l;
+	}
+	return len == 0 || fwrite(p, 1, len, fp) == len? 0 : -1;
+}
+
+/* check a mapped header against the instantiation; the arrays must lie
+ * where __ac_img_layout() puts them for this n_buckets, inside the file */
+static inline int __ac_img_check(const kh_img_hdr_t *hdr, const kh_img_hdr_t *ref, size_t len)
+{
+	kh_img_hdr_t chk;
+	if (memcmp(hdr->magic, __ac_IMG_MAGIC, 8) != 0 || hdr->idx_size != ref->idx_size || hdr->key_size != ref->key_size
+		|| hdr->val_size != ref->val_size || hdr->is_str != ref->is_str || hdr->policy != ref->policy || hdr->len != len)
+		return -1;
+	if (hdr->n_buckets > len || (hdr->idx_size < 8 && hdr->n_buckets > 0xffffffffU) /* also keeps the layout from overflowing */
+		|| hdr->size > hdr->n_buckets || hdr->upper_bound > hdr->n_buckets)
+		return -1;
+	chk = *hdr;
+	__ac_img_layout(&chk, 0);
+	if (chk.off_flags != hdr->off_flags || chk.off_keys != hdr->off_keys || chk.off_vals != hdr->off_vals
+		|| chk.off_pool != hdr->off_pool || hdr->off_pool > len)
+		return -1;
+	return 0;
+}
+
+/* map an image and check its header; returns the header or NULL */
+static inline const kh_img_hdr_t *__ac_img_map(const char *fn, int writable, const kh_img_hdr_t *ref, kh_img_t *img)
+{
+	int fd;
+	struct stat st;
+	const kh_img_hdr_t *hdr;
+	img->base = 0;
+	if ((fd = open(fn, O_RDONLY)) < 0) return 0;
+	if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(kh_img_hdr_t)) {
+		close(fd);
+		return 0;
+	}
+	img->len = st.st_size;
+	img->base = mmap(0, img->len, writable? PROT_READ|PROT_WRITE : PROT_READ, writable? MAP_PRIVATE : MAP_SHARED, fd, 0);
+	close(fd);
+	if (img->base == MAP_FAILED) {
+		img->base = 0;
+		return 0;
+	}
+	hdr = (const kh_img_hdr_t*)img->base;
+	if (__ac_img_check(hdr, ref, img->len) != 0) {
+		munmap(img->base, img->len);
+		img->base = 0;
+		return 0;
+	}
+	return hdr;
+}
+
+#define __KHASH_IMG_IMPL(name, khkey_t, khval_t, __is_str, __policy)	\
+	typedef struct {													\
+		kh_##name##_t h; /* must be the first member */					\
+		kh_img_t img;													\
+	} kh_img_##name##_t;												\
+	static inline void kh_img_hdr_##name(const kh_##name##_t *h, kh_img_hdr_t *hdr) \
+	{																	\
+		memset(hdr, 0, sizeof(kh_img_hdr_t));							\
+		hdr->idx_size = sizeof(h->n_buckets);							\
+		hdr->key_size = sizeof(khkey_t);								\
+		hdr->val_size = sizeof(khval_t);								\
+		hdr->is_map = h->vals != 0;										\
+		hdr->is_str = __is_str;											\
+		hdr->policy = __ac_IMG_POLICY_##__policy;						\
+		hdr->n_buckets = h->n_buckets;									\
+		hdr->size = h->size;											\
+		hdr->upper_bound = h->upper_bound;								\
+	}																	\
+	static inline int kh_save_##name(const kh_##name##_t *h, const char *fn) \
+	{																	\
+		kh_img_hdr_t hdr;												\
+		khint64_t i, pool_len = 0;										\
+		const void *keys = h->keys;										\
+		size_t *offs = 0;												\
+		FILE *fp;														\
+		int ret = 0;													\
+		kh_img_hdr_##name(h, &hdr);										\
+		if (__is_str) { /* replace pointers by offsets into the pool */	\
+			offs = (size_t*)calloc(h->n_buckets + 1, sizeof(size_t));	\
+			for (i = 0; i < h->n_buckets; ++i)							\
+				if (kh_exist(h, i)) {									\
+					offs[i] = pool_len;									\
+					pool_len += strlen(*(const char**)&h->keys[i]) + 1;	\
+				}														\
+			keys = offs;												\
+		}																\
+		__ac_img_layout(&hdr, pool_len);								\
+		if ((fp = fopen(fn, "wb")) == 0) {								\
+			free(offs);													\
+			return -1;													\
+		}																\
+		ret |= __ac_img_write_at(fp, 0, &hdr, sizeof(hdr));				\
+		if (h->n_buckets) {												\
+			ret |= __ac_img_write_at(fp, hdr.off_flags, h->flags, ((h->n_buckets>>4) + 1) * sizeof(khint32_t)); \
+			ret |= __ac_img_write_at(fp, hdr.off_keys, keys, h->n_buckets * sizeof(khkey_t)); \
+			if (hdr.is_map) ret |= __ac_img_write_at(fp, hdr.off_vals, h->vals, h->n_buckets * sizeof(khval_t)); \
+		}																\
+		ret |= __ac_img_write_at(fp, hdr.off_pool, 0, 0);				\
+		if (__is_str)													\
+			for (i = 0; i < h->n_buckets; ++i)							\
+				if (kh_exist(h, i)) {									\
+					const char *s = *(const char**)&h->keys[i];			\
+					if (fwrite(s, 1, strlen(s) + 1, fp) != strlen(s) + 1) ret = -1; \
+				}														\
+		if (fclose(fp) != 0) ret = -1;									\
+		free(offs);														\
+		return ret;														\
+	}																	\
+	static inline kh_##name##_t *kh_load_##name(const char *fn)			\
+	{																	\
+		kh_img_hdr_t ref;												\
+		const kh_img_hdr_t *hdr;										\
+		kh_img_##name##_t *m;											\
+		char *base;														\
+		m = (kh_img_##name##_t*)calloc(1, sizeof(kh_img_##name##_t));	\
+		kh_img_hdr_##name(&m->h, &ref);									\
+		if ((hdr = __ac_img_map(fn, __is_str, &ref, &m->img)) == 0) {	\
+			free(m);													\
+			return 0;													\
+		}																\
+		base = (char*)m->img.base;										\
+		m->h.n_buckets = hdr->n_buckets;								\
+		m->h.size = m->h.n_occupied = hdr->size;						\
+		m->h.upper_bound = hdr->upper_bound;							\
+		if (hdr->n_buckets) {											\
+			m->h.flags = (khint32_t*)(base + hdr->off_flags);			\
+			m->h.keys = (khkey_t*)(base + hdr->off_keys);				\
+			if (hdr->is_map) m->h.vals = (khval_t*)(base + hdr->off_vals); \
+		}																\
+		if (__is_str) { /* each key must start in the pool, which must end with a NUL */ \
+			khint64_t i, pool_len = hdr->len - hdr->off_pool;			\
+			const size_t *offs = (const size_t*)m->h.keys;				\
+			for (i = 0; i < hdr->n_buckets; ++i)						\
+				if (kh_exist(&m->h, i)) {								\
+					if (offs[i] >= pool_len || base[hdr->len - 1] != 0) { \
+						munmap(m->img.base, m->img.len);				\
+						free(m);										\
+						return 0;										\
+					}													\
+					*(const char**)&m->h.keys[i] = base + hdr->off_pool + offs[i]; \
+				}														\
+		}																\
+		return &m->h;													\
+	}																	\
+	static inline void kh_unload_##name(kh_##name##_t *h)				\
+	{																	\
+		kh_img_##name##_t *m = (kh_img_##name##_t*)h;					\
+		if (m == 0) return;												\
+		if (m->img.base) munmap(m->img.base, m->img.len);				\
+		free(m);														\
+	}
+
+/*! @function
+  @abstract     Instantiate image functions for a table with fixed-size keys
+  @param  name     Name of an existing hash table instantiation [symbol]
+  @param  khkey_t  Type of keys; must not contain pointers [type]
+  @param  khval_t  Type of values; must not contain pointers [type]
+  @param  __policy Bucket policy of the instantiation: prime for KHASH_INIT2,
+                   pow2 for KHASH_INIT2_POW2, pow2_64 for KHASH_INIT2_64 [symbol]
+ */
+#define KHASH_IMG_INIT(name, khkey_t, khval_t, __policy) __KHASH_IMG_IMPL(name, khkey_t, khval_t, 0, __policy)
+
+/*! @function
+  @abstract     Instantiate image functions for a table with const char* keys
+  @param  name     Name of an existing hash table instantiation [symbol]
+  @param  khval_t  Type of values; must not contain pointers [type]
+  @param  __policy Bucket policy of the instantiation, as for KHASH_IMG_INIT [symbol]
+ */
+#define KHASH_IMG_INIT_STR(name, khval_t, __policy) __KHASH_IMG_IMPL(name, kh_cstr_t, khval_t, 1, __policy)
+
+/*! @function
+  @abstract     Write a hash table to an image file.
+  @param  name  Name of the hash table [symbol]
+  @param  h     Pointer to the hash table [khash_t(name)*]
+  @param  fn    File name [const char*]
+  @return       0 on success; -1 on error [int]
+ */
+#define kh_save(name, h, fn) kh_save_##name(h, fn)
+
+/*! @function
+  @abstract     Map an image file as a read-only hash table.
+  @param  name  Name of the hash table [symbol]
+  @param  fn    File name [const char*]
+  @return       Pointer to the hash table, or NULL on error [khash_t(name)*]
+ */
+#define kh_load(name, fn) kh_load_##name(fn)
+
+/*! @function
+  @abstract     Unmap a hash table returned by kh_load().
+  @param  name  Name of the hash table [symbol]
+  @param  h     Pointer to the hash table [khash_t(name)*]
+ */
+#define kh_unload(name, h) kh_unload_##name(h)
+
+#endif /* __AC_KHASH_IMG_H */
@@ -0,0 +1,330 @@
+/* The MIT License
+
+   Copyright (c) 2026 by the khash contributors
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+/*
+  An example:
+
+#include "khash_lf.h"
+KHASH_LF_INIT_INT(32, khint32_t)
+static klf_t(32) *h; // shared by all threads
+static void *worker(void *data) {
+	klf_inc(32, h, (khint32_t)(size_t)data, 1); // lock-free
+	return 0;
+}
+int main() {
+	khint_t k;
+	h = klf_init(32, 0);
+	// ... start threads running worker() and join them ...
+	for (k = klf_begin(h); k != klf_end(32, h); ++k)
+		if (klf_exist(32, h, k))
+			printf("%u\t%u\n", klf_key(32, h, k), klf_val(32, h, k));
+	klf_destroy(32, h);
+	return 0;
+}
+*/
+
+#ifndef __AC_KHASH_LF_H
+#define __AC_KHASH_LF_H
+
+/*!
+  @header
+
+  Lock-free counting hash table for integer keys: insert-if-absent plus
+  atomic increment, no deletion. This is the `++kh_val(h, k)' pattern of a
+  khash counting map, callable from many threads at once.
+
+  A key is claimed with a compare-and-swap on its slot and counted with an
+  atomic fetch-and-add on its value. When a table gets too full, the
+  thread noticing it allocates a table twice as large and every thread
+  that touches the old table helps move it, __ac_LF_CHUNK buckets at a
+  time. A bucket is moved by marking an empty key as MOVED, or by setting
+  the top bit of the value (FROZEN) and adding the value to the new table.
+  An increment whose fetch-and-add returns a FROZEN value was not counted
+  in the old table and is redone in the new one, so no increment is lost.
+  Old tables are kept until klf_destroy().
+
+  Keys are unsigned integers; values are unsigned integers that must stay
+  below 2^(bits-1). klf_get() and the iterators are exact once no thread
+  is inserting. The iterators also cover the two key values that the table
+  reserves for itself, from klf_end()-2 to klf_end()-1.
+
+  This implementation relies on GCC's __sync and __atomic builtins.
+
+  @copyright the khash contributors
+ */
+
+#include "khash.h"
+
+#define __ac_LF_CHUNK 1024
+
+/* Fields written by other threads are read with acquire semantics; a new
+ * table is published by a compare-and-swap, a full barrier, so a thread
+ * that loads a table pointer also sees the table initialized */
+#define __ac_lf_load(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+
+#define KHASH_LF_INIT(name, khkey_t, khval_t, __hash_func)				\
+	typedef struct klf_##name##_tab_s {									\
+		khint_t n_buckets, upper_bound, n_chunks;						\
+		khint_t size, mig_next, mig_done;								\
+		khkey_t *keys;													\
+		khval_t *vals;													\
+		struct klf_##name##_tab_s *next;								\
+		struct klf_##name##_tab_s *old;									\
+	} klf_##name##_tab_t;												\
+	typedef struct {													\
+		klf_##name##_tab_t *cur;										\
+		khval_t sp_val[2];												\
+		int sp_used[2];													\
+	} klf_##name##_t;													\
+	static const khkey_t __klf_empty_##name = (khkey_t)~(khkey_t)0;		\
+	static const khkey_t __klf_moved_##name = (khkey_t)~(khkey_t)0 - 1;	\
+	static const khval_t __klf_frozen_##name = (khval_t)1 << (sizeof(khval_t) * CHAR_BIT - 1); \
+	static inline klf_##name##_tab_t *klf_tab_init_##name(khint_t n_buckets) \
+	{																	\
+		klf_##name##_tab_t *t;											\
+		t = (klf_##name##_tab_t*)calloc(1, sizeof(klf_##name##_tab_t));	\
+		t->n_buckets = __ac_pow2_size(n_buckets - 1);					\
+		t->upper_bound = t->n_buckets - (t->n_buckets >> 2);			\
+		t->n_chunks = (t->n_buckets + __ac_LF_CHUNK - 1) / __ac_LF_CHUNK; \
+		t->keys = (khkey_t*)malloc(t->n_buckets * sizeof(khkey_t));		\
+		t->vals = (khval_t*)calloc(t->n_buckets, sizeof(khval_t));		\
+		memset(t->keys, 0xff, t->n_buckets * sizeof(khkey_t));			\
+		return t;														\
+	}																	\
+	static inline klf_##name##_t *klf_init_##name(khint_t n_buckets)	\
+	{																	\
+		klf_##name##_t *h;												\
+		h = (klf_##name##_t*)calloc(1, sizeof(klf_##name##_t));			\
+		h->cur = klf_tab_init_##name(n_buckets > __ac_LF_CHUNK? n_buckets : __ac_LF_CHUNK); \
+		return h;														\
+	}																	\
+	static inline void klf_destroy_##name(klf_##name##_t *h)			\
+	{																	\
+		klf_##name##_tab_t *t, *p;										\
+		if (h == 0) return;												\
+		for (t = h->cur; t->next; t = t->next);							\
+		for (; t; t = p) {												\
+			p = t->old;													\
+			free(t->keys); free(t->vals); free(t);						\
+		}																\
+		free(h);														\
+	}																	\
+	static inline void klf_add_##name(klf_##name##_t *h, klf_##name##_tab_t *t, khkey_t key, khval_t delta); \
+	static inline void klf_help_##name(klf_##name##_t *h, klf_##name##_tab_t *t) \
+	{ /* move unclaimed chunks of t to t->next */						\
+		khint_t c;														\
+		while (__ac_lf_load(&t->mig_next) < t->n_chunks && (c = __sync_fetch_and_add(&t->mig_next, 1)) < t->n_chunks) { \
+			khint_t i, end = (c + 1) * __ac_LF_CHUNK < t->n_buckets? (c + 1) * __ac_LF_CHUNK : t->n_buckets; \
+			for (i = c * __ac_LF_CHUNK; i < end; ++i) {					\
+				khkey_t key = __sync_val_compare_and_swap(&t->keys[i], __klf_empty_##name, __klf_moved_##name); \
+				khval_t v;												\
+				if (key == __klf_empty_##name || key == __klf_moved_##name) continue; \
+				v = __sync_fetch_and_or(&t->vals[i], __klf_frozen_##name); \
+				if (v) klf_add_##name(h, __ac_lf_load(&t->next), key, v); \
+			}															\
+			__sync_fetch_and_add(&t->mig_done, 1);						\
+		}																\
+		if (__ac_lf_load(&t->mig_done) == t->n_chunks)					\
+			__sync_bool_compare_and_swap(&h->cur, t, __ac_lf_load(&t->next)); \
+	}																	\
+	static inline void klf_grow_##name(klf_##name##_tab_t *t)		\
+	{																	\
+		if (__ac_lf_load(&t->next) == 0) { /* t may still be receiving keys from an older table; that is fine */ \
+			klf_##name##_tab_t *n = klf_tab_init_##name(t->n_buckets << 1); \
+			n->old = t;													\
+			if (!__sync_bool_compare_and_swap(&t->next, 0, n)) {		\
+				free(n->keys); free(n->vals); free(n);					\
+			}															\
+		}																\
+	}																	\
+	static inline void klf_add_##name(klf_##name##_t *h, klf_##name##_tab_t *t, khkey_t key, khval_t delta) \
+	{																	\
+		khint_t k = __ac_fmix32(__hash_func(key));						\
+		while (1) {														\
+			khint_t i, inc, mask = t->n_buckets - 1;					\
+			klf_##name##_tab_t *n = __ac_lf_load(&t->next);				\
+			if (n) {													\
+				klf_help_##name(h, t);									\
+				t = n;													\
+				continue;												\
+			}															\
+			for (i = k & mask, inc = 0; inc < t->n_buckets; __ac_pow2_next(t->n_buckets, i, inc)) { \
+				khkey_t c = __ac_lf_load(&t->keys[i]);					\
+				if (c == __klf_empty_##name) {							\
+					if (__ac_lf_load(&t->size) >= t->upper_bound) break; \
+					c = __sync_val_compare_and_swap(&t->keys[i], __klf_empty_##name, key); \
+					if (c == __klf_empty_##name) {						\
+						__sync_fetch_and_add(&t->size, 1);				\
+						c = key;										\
+					}													\
+				}														\
+				if (c == key) {											\
+					if (!(__sync_fetch_and_add(&t->vals[i], delta) & __klf_frozen_##name)) return; \
+					break; /* frozen: t->next is set; count it there */	\
+				}														\
+				if (c == __klf_moved_##name) break;						\
+			}															\
+			klf_grow_##name(t);											\
+		}																\
+	}																	\
+	static inline void klf_inc_##name(klf_##name##_t *h, khkey_t key, khval_t delta) \
+	{																	\
+		if (key == __klf_empty_##name || key == __klf_moved_##name) {	\
+			int j = key == __klf_empty_##name? 0 : 1;					\
+			__sync_fetch_and_add(&h->sp_val[j], delta);					\
+			__atomic_store_n(&h->sp_used[j], 1, __ATOMIC_RELEASE);		\
+		} else klf_add_##name(h, __ac_lf_load(&h->cur), key, delta);	\
+	}																	\
+	static inline khval_t klf_get_##name(const klf_##name##_t *h, khkey_t key) \
+	{																	\
+		const klf_##name##_tab_t *t;									\
+		khint_t k = __ac_fmix32(__hash_func(key));						\
+		if (key == __klf_empty_##name) return __ac_lf_load(&h->sp_val[0]); \
+		if (key == __klf_moved_##name) return __ac_lf_load(&h->sp_val[1]); \
+		for (t = __ac_lf_load(&h->cur); t; t = __ac_lf_load(&t->next)) { \
+			khint_t i, inc, mask = t->n_buckets - 1;					\
+			for (i = k & mask, inc = 0; inc < t->n_buckets; __ac_pow2_next(t->n_buckets, i, inc)) { \
+				khkey_t c = __ac_lf_load(&t->keys[i]);					\
+				if (c == key) {											\
+					khval_t v = __ac_lf_load(&t->vals[i]);				\
+					if (!(v & __klf_frozen_##name)) return v;			\
+					break;												\
+				}														\
+				if (c == __klf_empty_##name || c == __klf_moved_##name) break; \
+			}															\
+		}																\
+		return 0;														\
+	}																	\
+	static inline const klf_##name##_tab_t *klf_tab_##name(const klf_##name##_t *h) \
+	{																	\
+		const klf_##name##_tab_t *t, *n;								\
+		for (t = __ac_lf_load(&h->cur); (n = __ac_lf_load(&t->next)) != 0; t = n); \
+		return t;														\
+	}																	\
+	static inline khint_t klf_end_##name(const klf_##name##_t *h)		\
+	{																	\
+		return klf_tab_##name(h)->n_buckets + 2;						\
+	}																	\
+	static inline int klf_exist_##name(const klf_##name##_t *h, khint_t x) \
+	{																	\
+		const klf_##name##_tab_t *t = klf_tab_##name(h);				\
+		khkey_t c;														\
+		if (x >= t->n_buckets) return __ac_lf_load(&h->sp_used[x - t->n_buckets]); \
+		c = __ac_lf_load(&t->keys[x]);									\
+		return c != __klf_empty_##name && c != __klf_moved_##name && __ac_lf_load(&t->vals[x]) != 0; \
+	}																	\
+	static inline khkey_t klf_key_##name(const klf_##name##_t *h, khint_t x) \
+	{																	\
+		const klf_##name##_tab_t *t = klf_tab_##name(h);				\
+		if (x >= t->n_buckets) return x == t->n_buckets? __klf_empty_##name : __klf_moved_##name; \
+		return __ac_lf_load(&t->keys[x]);								\
+	}																	\
+	static inline khval_t klf_val_##name(const klf_##name##_t *h, khint_t x) \
+	{																	\
+		const klf_##name##_tab_t *t = klf_tab_##name(h);				\
+		return __ac_lf_load(x >= t->n_buckets? &h->sp_val[x - t->n_buckets] : &t->vals[x]); \
+	}																	\
+	static inline khint_t klf_size_##name(const klf_##name##_t *h)		\
+	{																	\
+		const klf_##name##_tab_t *t = klf_tab_##name(h);				\
+		khint_t i, n = h->sp_used[0] + h->sp_used[1];					\
+		for (i = 0; i < t->n_buckets; ++i)								\
+			if (klf_exist_##name(h, i)) ++n;							\
+		return n;														\
+	}
+
+/*! @function
+  @abstract     Instantiate a lock-free counting table with 32-bit integer keys
+  @param  name     Name of the hash table [symbol]
+  @param  khval_t  Type of counts; must be unsigned [type]
+ */
+#define KHASH_LF_INIT_INT(name, khval_t) KHASH_LF_INIT(name, khint32_t, khval_t, kh_int_hash_func)
+
+/*! @function
+  @abstract     Instantiate a lock-free counting table with 64-bit integer keys
+  @param  name     Name of the hash table [symbol]
+  @param  khval_t  Type of counts; must be unsigned [type]
+ */
+#define KHASH_LF_INIT_INT64(name, khval_t) KHASH_LF_INIT(name, khint64_t, khval_t, kh_int64_hash_func)
+
+/*! @function
+  @abstract     Type of the lock-free counting table.
+ */
+#define klf_t(name) klf_##name##_t
+
+/*! @function
+  @abstract     Initiate a table with about n buckets.
+  @return       Pointer to the hash table [klf_t(name)*]
+ */
+#define klf_init(name, n) klf_init_##name(n)
+
+/*! @function
+  @abstract     Destroy a table. No other thread may use it.
+ */
+#define klf_destroy(name, h) klf_destroy_##name(h)
+
+/*! @function
+  @abstract     Add d to the count of a key, inserting it if absent; lock-free.
+  @param  k     Key [type of keys]
+  @param  d     Increment; must be positive [type of values]
+ */
+#define klf_inc(name, h, k, d) klf_inc_##name(h, k, d)
+
+/*! @function
+  @abstract     Get the count of a key, or 0 if absent.
+ */
+#define klf_get(name, h, k) klf_get_##name(h, k)
+
+/*! @function
+  @abstract     Get the start iterator.
+ */
+#define klf_begin(h) (khint_t)(0)
+
+/*! @function
+  @abstract     Get the end iterator; call only when no thread is inserting.
+ */
+#define klf_end(name, h) klf_end_##name(h)
+
+/*! @function
+  @abstract     Test whether a bucket contains a key.
+ */
+#define klf_exist(name, h, x) klf_exist_##name(h, x)
+
+/*! @function
+  @abstract     Get key given an iterator.
+ */
+#define klf_key(name, h, x) klf_key_##name(h, x)
+
+/*! @function
+  @abstract     Get count given an iterator.
+ */
+#define klf_val(name, h, x) klf_val_##name(h, x)
+
+/*! @function
+  @abstract     Get the number of keys; call only when no thread is inserting.
+ */
+#define klf_size(name, h) klf_size_##name(h)
+
+#endif /* __AC_KHASH_LF_H */
@@ -0,0 +1,252 @@
+/* The MIT License
+
+   Copyright (c) 2026 by the khash contributors
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+/*
+  An example:
+
+#include "khash_mt.h"
+KHASH_SHARD_MAP_INIT_STR(str, int)
+static khs_str_t *h; // shared by all threads
+static void *worker(void *data) {
+	char *s = (char*)data;
+	khs_inc(str, h, s, 1); // no global lock
+	return 0;
+}
+int main() {
+	int i, n;
+	khint_t k;
+	h = khs_init(str, 6); // 64 shards
+	// ... start threads running worker() and join them ...
+	for (i = n = 0; i < khs_n_shards(h); ++i) {
+		khash_t(str_s) *t = khs_table(h, i);
+		for (k = kh_begin(t); k != kh_end(t); ++k)
+			if (kh_exist(t, k)) n += kh_val(t, k);
+	}
+	khs_destroy(str, h);
+	return 0;
+}
+*/
+
+#ifndef __AC_KHASH_MT_H
+#define __AC_KHASH_MT_H
+
+/*!
+  @header
+
+  Hash table shared by multiple threads. The table is split into 2^bits
+  KHASH_INIT2_POW2 shards, each guarded by its own mutex; a key goes to
+  the shard given by the top bits of its (mixed) hash, and the low bits
+  index the bucket inside the shard. Threads working on different shards
+  never contend. Shard headers are cache-line aligned to avoid false
+  sharing between locks.
+
+  @copyright the khash contributors
+ */
+
+#include <pthread.h>
+#include "khash.h"
+
+#define __ac_SHARD_LINE 64
+
+#define __KHASH_SHARD_IMPL(name, khkey_t, khval_t, __hash_func, __hash_equal, __key_dup, __key_free) \
+	KHASH_INIT_POW2(name##_s, khkey_t, khval_t, 1, __hash_func, __hash_equal) \
+	typedef struct {													\
+		pthread_mutex_t lock;											\
+		kh_##name##_s_t *h;												\
+		char pad[__ac_SHARD_LINE - (sizeof(pthread_mutex_t) + sizeof(void*)) % __ac_SHARD_LINE]; \
+	} khs_##name##_shard_t;												\
+	typedef struct {													\
+		int bits;														\
+		khs_##name##_shard_t *shards;									\
+	} khs_##name##_t;													\
+	static inline khs_##name##_t *khs_init_##name(int bits)				\
+	{																	\
+		khs_##name##_t *h;												\
+		void *p;														\
+		int i;															\
+		if (posix_memalign(&p, __ac_SHARD_LINE, sizeof(khs_##name##_shard_t) << bits) != 0) return 0; \
+		h = (khs_##name##_t*)calloc(1, sizeof(khs_##name##_t));		\
+		h->bits = bits;													\
+		h->shards = (khs_##name##_shard_t*)p;							\
+		for (i = 0; i < 1<<bits; ++i) {									\
+			pthread_mutex_init(&h->shards[i].lock, 0);					\
+			h->shards[i].h = kh_init(name##_s);							\
+		}																\
+		return h;														\
+	}																	\
+	static inline void khs_destroy_##name(khs_##name##_t *h)			\
+	{																	\
+		int i;															\
+		khint_t k;														\
+		if (h == 0) return;												\
+		for (i = 0; i < 1<<h->bits; ++i) {								\
+			kh_##name##_s_t *t = h->shards[i].h;						\
+			for (k = 0; k != t->n_buckets; ++k)							\
+				if (kh_exist(t, k)) __key_free(kh_key(t, k));			\
+			kh_destroy(name##_s, t);									\
+			pthread_mutex_destroy(&h->shards[i].lock);					\
+		}																\
+		free(h->shards); free(h);										\
+	}																	\
+	static inline khs_##name##_shard_t *khs_shard_##name(const khs_##name##_t *h, khint_t k) \
+	{ /* k is the mixed hash; the shard uses bits independent from the in-shard index */ \
+		return h->bits? &h->shards[(k * 0x9e3779b1U) >> (32 - h->bits)] : h->shards; \
+	}																	\
+	static inline int khs_get_##name(khs_##name##_t *h, khkey_t key, khval_t *val) \
+	{																	\
+		khint_t k = __ac_pow2_hash(__hash_func(key)), x;				\
+		khs_##name##_shard_t *s = khs_shard_##name(h, k);				\
+		int absent;														\
+		pthread_mutex_lock(&s->lock);									\
+		x = kh_get_hashed_##name##_s(s->h, key, k);						\
+		absent = (x == kh_end(s->h));									\
+		if (!absent && val) *val = kh_val(s->h, x);						\
+		pthread_mutex_unlock(&s->lock);									\
+		return !absent;													\
+	}																	\
+	static inline int khs_put_##name(khs_##name##_t *h, khkey_t key, khval_t val) \
+	{																	\
+		khint_t k = __ac_pow2_hash(__hash_func(key)), x;				\
+		khs_##name##_shard_t *s = khs_shard_##name(h, k);				\
+		int ret;														\
+		pthread_mutex_lock(&s->lock);									\
+		x = kh_put_hashed_##name##_s(s->h, key, k, &ret);				\
+		if (ret) kh_key(s->h, x) = __key_dup(key);						\
+		kh_val(s->h, x) = val;											\
+		pthread_mutex_unlock(&s->lock);									\
+		return ret;														\
+	}																	\
+	static inline khval_t khs_inc_##name(khs_##name##_t *h, khkey_t key, khval_t delta) \
+	{																	\
+		khint_t k = __ac_pow2_hash(__hash_func(key)), x;				\
+		khs_##name##_shard_t *s = khs_shard_##name(h, k);				\
+		khval_t v;														\
+		int ret;														\
+		pthread_mutex_lock(&s->lock);									\
+		x = kh_put_hashed_##name##_s(s->h, key, k, &ret);				\
+		if (ret) {														\
+			kh_key(s->h, x) = __key_dup(key);							\
+			v = kh_val(s->h, x) = delta;								\
+		} else v = kh_val(s->h, x) += delta;							\
+		pthread_mutex_unlock(&s->lock);									\
+		return v;														\
+	}																	\
+	static inline size_t khs_size_##name(khs_##name##_t *h)			\
+	{																	\
+		size_t n = 0;													\
+		int i;															\
+		for (i = 0; i < 1<<h->bits; ++i) {								\
+			pthread_mutex_lock(&h->shards[i].lock);						\
+			n += kh_size(h->shards[i].h);								\
+			pthread_mutex_unlock(&h->shards[i].lock);					\
+		}																\
+		return n;														\
+	}
+
+#define __ac_key_nodup(key) (key)
+#define __ac_key_nofree(key) ((void)(key))
+#define __ac_key_strdup(key) strdup(key)
+#define __ac_key_strfree(key) free((char*)(key))
+
+/*! @function
+  @abstract     Instantiate a sharded hash map; keys are stored as given
+  @param  name  Name of the hash table [symbol]; the shards are khash_t(name_s)
+ */
+#define KHASH_SHARD_INIT(name, khkey_t, khval_t, __hash_func, __hash_equal) \
+	__KHASH_SHARD_IMPL(name, khkey_t, khval_t, __hash_func, __hash_equal, __ac_key_nodup, __ac_key_nofree)
+
+/*! @function
+  @abstract     Instantiate a sharded hash map containing integer keys
+ */
+#define KHASH_SHARD_MAP_INIT_INT(name, khval_t)							\
+	KHASH_SHARD_INIT(name, khint32_t, khval_t, kh_int_hash_func, kh_int_hash_equal)
+
+/*! @function
+  @abstract     Instantiate a sharded hash map containing 64-bit integer keys
+ */
+#define KHASH_SHARD_MAP_INIT_INT64(name, khval_t)						\
+	KHASH_SHARD_INIT(name, khint64_t, khval_t, kh_int64_hash_func, kh_int64_hash_equal)
+
+/*! @function
+  @abstract     Instantiate a sharded hash map containing const char* keys
+  @discussion   A key is copied with strdup() when it is inserted, so threads
+                may pass pointers into their own buffers; copies are freed by
+                khs_destroy().
+ */
+#define KHASH_SHARD_MAP_INIT_STR(name, khval_t)							\
+	__KHASH_SHARD_IMPL(name, kh_cstr_t, khval_t, kh_str_hash_func, kh_str_hash_equal, __ac_key_strdup, __ac_key_strfree)
+
+/*! @function
+  @abstract     Type of the sharded hash table.
+ */
+#define khs_t(name) khs_##name##_t
+
+/*! @function
+  @abstract     Initiate a sharded hash table with 2^bits shards.
+  @return       Pointer to the hash table [khs_t(name)*]
+ */
+#define khs_init(name, bits) khs_init_##name(bits)
+
+/*! @function
+  @abstract     Destroy a sharded hash table. No other thread may use it.
+ */
+#define khs_destroy(name, h) khs_destroy_##name(h)
+
+/*! @function
+  @abstract     Retrieve the value of a key; thread-safe.
+  @param  v     Output: the value if present; may be NULL [type of values*]
+  @return       1 if the key is present; 0 otherwise [int]
+ */
+#define khs_get(name, h, k, v) khs_get_##name(h, k, v)
+
+/*! @function
+  @abstract     Insert a key, or overwrite its value; thread-safe.
+  @return       Return code of kh_put(): 0 if the key was present [int]
+ */
+#define khs_put(name, h, k, v) khs_put_##name(h, k, v)
+
+/*! @function
+  @abstract     Add d to the value of a key, inserting it with value d if absent; thread-safe.
+  @return       The new value [type of values]
+ */
+#define khs_inc(name, h, k, d) khs_inc_##name(h, k, d)
+
+/*! @function
+  @abstract     Get the number of elements; exact only if no thread is inserting.
+ */
+#define khs_size(name, h) khs_size_##name(h)
+
+/*! @function
+  @abstract     Number of shards of a sharded hash table [int]
+ */
+#define khs_n_shards(h) (1<<(h)->bits)
+
+/*! @function
+  @abstract     Get the i-th shard, e.g. to iterate after all threads have finished
+  @return       Pointer to the shard [khash_t(name_s)*]
+ */
+#define khs_table(m, i) ((m)->shards[i].h)
+
+#endif /* __AC_KHASH_MT_H */
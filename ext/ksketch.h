@@ -0,0 +1,408 @@
+/* The MIT License
+
+   Copyright (c) 2026 by the khash contributors
+
+   Permission is hereby granted, free of charge, to any person obtaining
+   a copy of this software and associated documentation files (the
+   "Software"), to deal in the Software without restriction, including
+   without limitation the rights to use, copy, modify, merge, publish,
+   distribute, sublicense, and/or sell copies of the Software, and to
+   permit persons to whom the Software is furnished to do so, subject to
+   the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+
+/*
+  An example:
+
+#include "ksketch.h"
+KSS_INIT_STR(str)
+int main() {
+	int i;
+	const char *a[] = { "x", "y", "x", "z", "x" };
+	kcm_t *cm = kcm_init(4, 16);  // 4 rows of 2^16 counters
+	khll_t *hll = khll_init(12);  // 2^12 registers
+	kss_t(str) *ss = kss_init(str, 2); // track the 2 heaviest keys
+	for (i = 0; i < 5; ++i) {
+		khint64_t x = kh_strn_hash_func64(a[i], strlen(a[i]));
+		kcm_add(cm, x, 1);
+		khll_add(hll, x);
+		kss_add(str, ss, a[i], 1);
+	}
+	printf("%.1f distinct; x seen %u times\n", khll_count(hll),
+		   kcm_get(cm, kh_strn_hash_func64("x", 1)));
+	i = kss_max(str, ss); // slot of the most frequent key
+	printf("%s: <=%lu\n", kss_key(ss, i), (unsigned long)kss_cnt(ss, i));
+	kss_destroy(str, ss); khll_destroy(hll); kcm_destroy(cm);
+	return 0;
+}
+*/
+
+#ifndef __AC_KSKETCH_H
+#define __AC_KSKETCH_H
+
+/*!
+  @header
+
+  Streaming approximate counting in bounded memory, for inputs whose
+  distinct keys do not fit in a hash table:
+
+  kcm_t   Count-Min sketch with conservative update; kcm_get() never
+          underestimates and overestimates by at most e/2^bits of the total
+          count with probability 1-e^-d.
+  kss_t   Space-Saving top-k, with the k tracked keys in a khash table and
+          a min-heap on their counts; any key occurring more than n/k times
+          in a stream of n is tracked, and its count is overestimated by at
+          most the err of its slot.
+  khll_t  HyperLogLog distinct counter; relative error about 1.04/2^(p/2).
+
+  kcm_t and khll_t take a 64-bit hash rather than a key; it must be well
+  mixed, e.g. kh_strn_hash_func64() or __ac_fmix64().
+
+  @copyright the khash contributors
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "khash.h"
+
+/********************
+ * Count-Min sketch *
+ ********************/
+
+#define __ac_CM_MAX_D 16
+
+typedef struct {
+	int d, bits;
+	khint32_t *cnt; /* d rows of 2^bits counters, row after row */
+} kcm_t;
+
+/*! @function
+  @abstract     Initiate a Count-Min sketch with d (<=16) rows of 2^bits counters.
+ */
+static inline kcm_t *kcm_init(int d, int bits)
+{
+	kcm_t *c;
+	if (d < 1 || d > __ac_CM_MAX_D || bits < 1 || bits > 31) return 0;
+	c = (kcm_t*)calloc(1, sizeof(kcm_t));
+	c->d = d, c->bits = bits;
+	c->cnt = (khint32_t*)calloc((size_t)d << bits, sizeof(khint32_t));
+	return c;
+}
+
+static inline void kcm_destroy(kcm_t *c)
+{
+	if (c) free(c->cnt), free(c);
+}
+
+/* Counter of each row, by double hashing on the two halves of x */
+static inline void __ac_cm_index(const kcm_t *c, khint64_t x, size_t *idx)
+{
+	khint32_t h1 = (khint32_t)x, h2 = (khint32_t)(x >> 32) | 1, mask = (1U << c->bits) - 1;
+	int i;
+	for (i = 0; i < c->d; ++i)
+		idx[i] = ((size_t)i << c->bits) + ((h1 + (khint32_t)i * h2) & mask);
+}
+
+/*! @function
+  @abstract     Get the estimated count of a hash.
+ */
+static inline khint32_t kcm_get(const kcm_t *c, khint64_t x)
+{
+	size_t idx[__ac_CM_MAX_D];
+	khint32_t min = 0xffffffffU;
+	int i;
+	__ac_cm_index(c, x, idx);
+	for (i = 0; i < c->d; ++i)
+		if (c->cnt[idx[i]] < min) min = c->cnt[idx[i]];
+	return min;
+}
+
+/*! @function
+  @abstract     Add v to the count of a hash; counters saturate at 2^32-1.
+  @return       The new estimated count [khint32_t]
+ */
+static inline khint32_t kcm_add(kcm_t *c, khint64_t x, khint32_t v)
+{
+	size_t idx[__ac_CM_MAX_D];
+	khint32_t min = 0xffffffffU;
+	int i;
+	__ac_cm_index(c, x, idx);
+	for (i = 0; i < c->d; ++i)
+		if (c->cnt[idx[i]] < min) min = c->cnt[idx[i]];
+	min = min > 0xffffffffU - v? 0xffffffffU : min + v;
+	for (i = 0; i < c->d; ++i) /* conservative update: raise only the counters below the new estimate */
+		if (c->cnt[idx[i]] < min) c->cnt[idx[i]] = min;
+	return min;
+}
+
+/***************
+ * HyperLogLog *
+ ***************/
+
+typedef struct {
+	int p;
+	khint8_t *reg;
+} khll_t;
+
+static inline int __ac_clz64(khint64_t x) /* x != 0 */
+{
+#ifdef __GNUC__
+	return __builtin_clzll(x);
+#else
+	int n = 0;
+	while (!(x & 0x8000000000000000ULL)) x <<= 1, ++n;
+	return n;
+#endif
+}
+
+/*! @function
+  @abstract     Initiate a HyperLogLog counter with 2^p (4<=p<=18) registers.
+ */
+static inline khll_t *khll_init(int p)
+{
+	khll_t *h;
+	if (p < 4 || p > 18) return 0;
+	h = (khll_t*)calloc(1, sizeof(khll_t));
+	h->p = p;
+	h->reg = (khint8_t*)calloc(1U << p, 1);
+	return h;
+}
+
+static inline void khll_destroy(khll_t *h)
+{
+	if (h) free(h->reg), free(h);
+}
+
+/*! @function
+  @abstract     Add a hash to a HyperLogLog counter.
+ */
+static inline void khll_add(khll_t *h, khint64_t x)
+{
+	khint64_t i = x >> (64 - h->p);
+	int rho = __ac_clz64(x << h->p | 1ULL << (h->p - 1)) + 1; /* the guard bit caps rho at 65-p */
+	if (rho > h->reg[i]) h->reg[i] = (khint8_t)rho;
+}
+
+/*! @function
+  @abstract     Merge a HyperLogLog counter of the same p into another.
+ */
+static inline void khll_merge(khll_t *dst, const khll_t *src)
+{
+	khint32_t i;
+	for (i = 0; i < 1U << dst->p; ++i)
+		if (src->reg[i] > dst->reg[i]) dst->reg[i] = src->reg[i];
+}
+
+/* Natural log of x >= 1, kept here so that users need not link libm:
+ * x = 2^e * y with y in [1,2), and ln(y) = 2 atanh((y-1)/(y+1)), whose
+ * series converges by a factor of 9 or more per term */
+static inline double __ac_log(double x)
+{
+	double z, z2, t, s = 0.0;
+	int e = 0, i;
+	while (x >= 2.0) x *= 0.5, ++e;
+	z = (x - 1.0) / (x + 1.0), z2 = z * z;
+	for (i = 1, t = z; i < 40; i += 2, t *= z2) s += t / i;
+	return 2.0 * s + e * 0.69314718055994530942;
+}
+
+/*! @function
+  @abstract     Estimate the number of distinct hashes added.
+ */
+static inline double khll_count(const khll_t *h)
+{
+	khint32_t i, m = 1U << h->p, n_zero = 0;
+	double sum = 0.0, alpha, e;
+	for (i = 0; i < m; ++i) {
+		sum += 1.0 / (double)(1ULL << h->reg[i]); /* reg <= 61 */
+		n_zero += (h->reg[i] == 0);
+	}
+	alpha = m == 16? 0.673 : m == 32? 0.697 : m == 64? 0.709 : 0.7213 / (1.0 + 1.079 / m);
+	e = alpha * m * m / sum;
+	if (e <= 2.5 * m && n_zero) e = m * __ac_log((double)m / n_zero); /* linear counting for small sets */
+	return e;
+}
+
+/***********************
+ * Space-Saving top-k *
+ ***********************/
+
+#define __KSS_IMPL(name, khkey_t, __hash_func, __hash_equal, __key_dup, __key_free) \
+	KHASH_INIT(name##_ss, khkey_t, khint32_t, 1, __hash_func, __hash_equal) \
+	typedef struct {													\
+		khkey_t key;													\
+		khint64_t cnt, err; /* cnt-err <= true count <= cnt */			\
+	} kss_##name##_slot_t;												\
+	typedef struct {													\
+		khint32_t k, n;													\
+		kss_##name##_slot_t *slot;										\
+		khint32_t *heap, *pos; /* min-heap of slots by cnt, and the heap position of each slot */ \
+		kh_##name##_ss_t *h; /* key -> slot */							\
+	} kss_##name##_t;													\
+	static inline kss_##name##_t *kss_init_##name(khint32_t k)			\
+	{																	\
+		kss_##name##_t *s;												\
+		if (k == 0) return 0;											\
+		s = (kss_##name##_t*)calloc(1, sizeof(kss_##name##_t));			\
+		s->k = k;														\
+		s->slot = (kss_##name##_slot_t*)calloc(k, sizeof(kss_##name##_slot_t)); \
+		s->heap = (khint32_t*)malloc(k * sizeof(khint32_t));			\
+		s->pos = (khint32_t*)malloc(k * sizeof(khint32_t));				\
+		s->h = kh_init(name##_ss);										\
+		kh_resize(name##_ss, s->h, k + (k >> 1) + 1);					\
+		return s;														\
+	}																	\
+	static inline void kss_destroy_##name(kss_##name##_t *s)			\
+	{																	\
+		khint32_t i;													\
+		if (s == 0) return;												\
+		for (i = 0; i < s->n; ++i) __key_free(s->slot[i].key);			\
+		kh_destroy(name##_ss, s->h);									\
+		free(s->slot); free(s->heap); free(s->pos); free(s);			\
+	}																	\
+	static inline void kss_heap_swap_##name(kss_##name##_t *s, khint32_t i, khint32_t j) \
+	{																	\
+		khint32_t t = s->heap[i]; s->heap[i] = s->heap[j]; s->heap[j] = t; \
+		s->pos[s->heap[i]] = i, s->pos[s->heap[j]] = j;					\
+	}																	\
+	static inline void kss_heap_down_##name(kss_##name##_t *s, khint32_t i) \
+	{																	\
+		for (;;) {														\
+			khint32_t l = 2 * i + 1, m = i;								\
+			if (l < s->n && s->slot[s->heap[l]].cnt < s->slot[s->heap[m]].cnt) m = l; \
+			if (l + 1 < s->n && s->slot[s->heap[l+1]].cnt < s->slot[s->heap[m]].cnt) m = l + 1; \
+			if (m == i) break;											\
+			kss_heap_swap_##name(s, i, m);								\
+			i = m;														\
+		}																\
+	}																	\
+	static inline void kss_heap_up_##name(kss_##name##_t *s, khint32_t i) \
+	{																	\
+		while (i > 0 && s->slot[s->heap[(i-1)/2]].cnt > s->slot[s->heap[i]].cnt) { \
+			kss_heap_swap_##name(s, i, (i-1)/2);						\
+			i = (i-1)/2;												\
+		}																\
+	}																	\
+	static inline khint64_t kss_add_##name(kss_##name##_t *s, khkey_t key, khint64_t v) \
+	{																	\
+		khint_t k;														\
+		khint32_t j;													\
+		int ret;														\
+		k = kh_get(name##_ss, s->h, key);								\
+		if (k != kh_end(s->h)) {										\
+			j = kh_val(s->h, k);										\
+			s->slot[j].cnt += v;										\
+			kss_heap_down_##name(s, s->pos[j]);							\
+			return s->slot[j].cnt;										\
+		}																\
+		if (s->n < s->k) { /* a free slot */							\
+			j = s->n++;													\
+			s->slot[j].cnt = v, s->slot[j].err = 0;						\
+			s->heap[s->n - 1] = j, s->pos[j] = s->n - 1;				\
+			s->slot[j].key = __key_dup(key);							\
+			kh_val(s->h, kh_put(name##_ss, s->h, s->slot[j].key, &ret)) = j; \
+			kss_heap_up_##name(s, s->n - 1);							\
+			return v;													\
+		}																\
+		j = s->heap[0]; /* replace the key with the smallest count */	\
+		kh_del(name##_ss, s->h, kh_get(name##_ss, s->h, s->slot[j].key)); \
+		__key_free(s->slot[j].key);										\
+		s->slot[j].key = __key_dup(key);								\
+		s->slot[j].err = s->slot[j].cnt;								\
+		s->slot[j].cnt += v;											\
+		kh_val(s->h, kh_put(name##_ss, s->h, s->slot[j].key, &ret)) = j; \
+		kss_heap_down_##name(s, 0);										\
+		return s->slot[j].cnt;											\
+	}																	\
+	static inline int kss_max_##name(const kss_##name##_t *s)			\
+	{																	\
+		khint32_t i;													\
+		int max = -1;													\
+		for (i = 0; i < s->n; ++i)										\
+			if (max < 0 || s->slot[i].cnt > s->slot[max].cnt) max = (int)i; \
+		return max;														\
+	}
+
+#define __ac_kss_key_nodup(key) (key)
+#define __ac_kss_key_nofree(key) ((void)(key))
+#define __ac_kss_key_strdup(key) strdup(key)
+#define __ac_kss_key_strfree(key) free((char*)(key))
+
+/*! @function
+  @abstract     Instantiate a Space-Saving top-k tracker; keys are stored as given
+  @param  name  Name of the tracker [symbol]; keys are indexed by khash_t(name_ss)
+ */
+#define KSS_INIT(name, khkey_t, __hash_func, __hash_equal)				\
+	__KSS_IMPL(name, khkey_t, __hash_func, __hash_equal, __ac_kss_key_nodup, __ac_kss_key_nofree)
+
+/*! @function
+  @abstract     Instantiate a Space-Saving top-k tracker containing 64-bit integer keys
+ */
+#define KSS_INIT_INT64(name)											\
+	KSS_INIT(name, khint64_t, kh_int64_hash_func, kh_int64_hash_equal)
+
+/*! @function
+  @abstract     Instantiate a Space-Saving top-k tracker containing const char* keys
+  @discussion   A tracked key is copied with strdup(), and freed when it is
+                evicted or the tracker is destroyed.
+ */
+#define KSS_INIT_STR(name)												\
+	__KSS_IMPL(name, kh_cstr_t, kh_str_hash_func, kh_str_hash_equal, __ac_kss_key_strdup, __ac_kss_key_strfree)
+
+/*! @function
+  @abstract     Type of the Space-Saving tracker.
+ */
+#define kss_t(name) kss_##name##_t
+
+/*! @function
+  @abstract     Initiate a tracker of the k most frequent keys.
+  @return       Pointer to the tracker [kss_t(name)*]
+ */
+#define kss_init(name, k) kss_init_##name(k)
+
+/*! @function
+  @abstract     Destroy a tracker.
+ */
+#define kss_destroy(name, s) kss_destroy_##name(s)
+
+/*! @function
+  @abstract     Add v occurrences of a key.
+  @return       Upper bound of the count of the key [khint64_t]
+ */
+#define kss_add(name, s, key, v) kss_add_##name(s, key, v)
+
+/*! @function
+  @abstract     Number of slots in use; slots are indexed from 0 [khint32_t]
+ */
+#define kss_n(s) ((s)->n)
+
+/*! @function
+  @abstract     Key, upper bound of the count, and overestimation bound of a slot
+ */
+#define kss_key(s, i) ((s)->slot[i].key)
+#define kss_cnt(s, i) ((s)->slot[i].cnt)
+#define kss_err(s, i) ((s)->slot[i].err)
+
+/*! @function
+  @abstract     Upper bound of the count of any key not tracked; 0 while a slot is free [khint64_t]
+ */
+#define kss_floor(s) ((s)->n < (s)->k? 0 : (s)->slot[(s)->heap[0]].cnt)
+
+/*! @function
+  @abstract     Slot with the largest count; -1 if the tracker is empty [int]
+ */
+#define kss_max(name, s) kss_max_##name(s)
+
+#endif /* __AC_KSKETCH_H */